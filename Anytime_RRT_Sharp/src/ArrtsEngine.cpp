@@ -11,23 +11,31 @@ void ArrtsEngine::_printProgress(int count, int minCount)
     }
 }
 
-void ArrtsEngine::_rewireNodes(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, vector<ConfigspaceNode>& remainingNodes, ConfigspaceNode& addedNode)
+void ArrtsEngine::_rewireNodes(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, vector<ConfigspaceNode>& remainingNodes, ConfigspaceNode& addedNode, ManeuverEvaluationCache& evaluations)
 {
     ConfigspaceNode remainingNodeParent, newNode;
-    vector<State> path;
 
     for (ConfigspaceNode rn : remainingNodes)
     {
-        path = ManeuverEngine::generatePath(rn, addedNode);
+        // an earlier rewire in this loop may have lowered its cost through propagation
+        rn = configGraph.nodes[rn.id()];
+
+        // skip without building a maneuver if even the lower bound on the cost through
+        // the added node is no cheaper than the current cost
+        if (rn.cost() < addedNode.cost() + configGraph.computeCostLowerBound(rn, addedNode))
+            continue;
 
         // check if it is cheaper for the current remaining node to use the added node as
         // its parent node
-        if (!path.empty() && !_compareNodes(configGraph, rn, addedNode) && workGraph.pathIsSafe(rn, addedNode))
+        if (_compareNodes(configGraph, rn, addedNode, evaluations))
+            continue;
+
+        // the maneuver built for the cost comparison is reused for the safety check
+        if (evaluations.evaluate(rn, addedNode).isSafe(workGraph))
         {
             // if it's cheaper, then create the new node, set the new cost, and set
             // the parent (now the added node)
-            newNode = configGraph.connectNodes(addedNode, rn);
-            newNode.setPathTo(path);
+            newNode = configGraph.connectNodes(addedNode, rn, &evaluations);
 
             // get the old parent of the current remaining node, remove the old
             // edge, add the new edge, and replace the old remaining node
@@ -42,25 +50,25 @@ void ArrtsEngine::_rewireNodes(ConfigspaceGraph& configGraph, WorkspaceGraph& wo
     }
 }
 
-void ArrtsEngine::_tryConnectToBestNeighbor(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, vector<ConfigspaceNode>& neighbors, ConfigspaceNode& newNode, ConfigspaceNode& parentNode)
+void ArrtsEngine::_tryConnectToBestNeighbor(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, vector<ConfigspaceNode>& neighbors, ConfigspaceNode& newNode, ConfigspaceNode& parentNode, ManeuverEvaluationCache& evaluations)
 {
     while (!neighbors.empty())
     {
         // find the best safe neighbor and connect newNode and the bestNeighbor
         // assign the resulting node to tempNode
-        auto bestNeighbor = configGraph.findBestNeighbor(newNode, neighbors);
-        auto tempNode = configGraph.connectNodes(bestNeighbor, newNode);
+        auto bestNeighbor = configGraph.findBestNeighbor(newNode, neighbors, newNode.cost(), &evaluations);
+        if (!bestNeighbor.id())
+            return;
+        auto tempNode = configGraph.connectNodes(bestNeighbor, newNode, &evaluations);
 
         // if the tempNode is cheaper then try to make that the newNode
         if (tempNode.cost() < newNode.cost())
         {
-            auto path = ManeuverEngine::generatePath(tempNode, bestNeighbor);
-            if (workGraph.pathIsSafe(path))
+            if (evaluations.evaluate(tempNode, bestNeighbor).isSafe(workGraph))
             {
                 newNode = tempNode;
                 parentNode = bestNeighbor;
                 configGraph.removeNode(neighbors, bestNeighbor);
-                newNode.setPathTo(path);
                 return;
             }
             else
@@ -83,34 +91,334 @@ void ArrtsEngine::_tryConnectToBestNeighbor(ConfigspaceGraph& configGraph, Works
     }
 }
 
-bool ArrtsEngine::_compareNodes(ConfigspaceGraph& configGraph, ConfigspaceNode& n1, ConfigspaceNode& n2)
+bool ArrtsEngine::_compareNodes(ConfigspaceGraph& configGraph, ConfigspaceNode& n1, ConfigspaceNode& n2, ManeuverEvaluationCache& evaluations)
+{
+    if (n1.cost() < (n2.cost() + configGraph.computeCost(n1, n2, &evaluations)))
+        return true;
+    return false;
+}
+
+void ArrtsEngine::_applyLookahead(ConfigspaceGraph& configGraph, LookaheadQueue& queue, ConfigspaceNode& node)
+{
+    // the lookahead parent may have become cheaper since the lookahead was recorded
+    Lookahead lookahead = queue.lookahead(node.id());
+    auto& parentNode = configGraph.nodes[lookahead.parentId];
+    double cost = parentNode.cost() + lookahead.pathLength;
+    if (cost >= node.cost())
+        return;
+
+    if (lookahead.parentId == (unsigned long)node.parentId())
+    {
+        configGraph.setNodeCost(node.id(), cost);
+    }
+    else
+    {
+        ConfigspaceNode newNode = node;
+        newNode.setParentId(parentNode.id());
+        newNode.setPathLength(lookahead.pathLength);
+        newNode.setCost(cost);
+
+        configGraph.removeEdge(node.parentId(), node.id());
+        configGraph.addEdge(parentNode, newNode);
+        configGraph.replaceNode(node, newNode);
+    }
+
+    node = configGraph.nodes[node.id()];
+    queue.relax(node.id(), cost, lookahead.parentId, lookahead.pathLength);
+}
+
+unsigned long ArrtsEngine::_replan(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, LookaheadQueue& queue, double epsilon, int maxNeighborCount, ManeuverEvaluationCache& evaluations, steady_clock::time_point deadline, PlannerHandle* handle)
+{
+    ConfigspaceNode node, child;
+    vector<ConfigspaceNode> neighbors;
+    unsigned long expansions = 0;
+    const GoalNodeSet& goalNodes = configGraph.goalNodes();
+
+    // costs only decrease, so a node whose key can't beat the goal cost never has to be expanded;
+    // it stays queued and its descendants keep their old, higher costs
+    while (queue.topKey() < goalNodes.bestCost() && !_interrupted(handle, deadline))
+    {
+        node = configGraph.nodes[queue.pop()];
+        _applyLookahead(configGraph, queue, node);
+        ++expansions;
+
+        // children keep their maneuvers, so their lookahead follows from the new cost alone
+        for (unsigned long id = configGraph.firstChildId(node.id()); id; id = configGraph.nextSiblingId(id))
+        {
+            child = configGraph.nodes[id];
+            double cost = node.cost() + child.pathLength();
+            if (queue.relax(id, cost, node.id(), child.pathLength()) && cost + queue.costToGoalLowerBound(child) < goalNodes.bestCost())
+                queue.push(child);
+        }
+
+        // neighbors need a new maneuver, which is only built if its lower bound is promising
+        neighbors = configGraph.findNeighbors(node, epsilon, maxNeighborCount);
+        for (auto& neighbor : neighbors)
+        {
+            double lookaheadCost = queue.lookahead(neighbor.id()).cost;
+            double costBound = node.cost() + configGraph.computeCostLowerBound(neighbor, node);
+            if (costBound >= lookaheadCost || costBound + queue.costToGoalLowerBound(neighbor) >= goalNodes.bestCost())
+                continue;
+
+            double pathLength = configGraph.computeCost(neighbor, node, &evaluations);
+            double cost = node.cost() + pathLength;
+            if (cost >= lookaheadCost || cost + queue.costToGoalLowerBound(neighbor) >= goalNodes.bestCost())
+                continue;
+
+            if (evaluations.evaluate(neighbor, node).isSafe(workGraph))
+            {
+                queue.relax(neighbor.id(), cost, node.id(), pathLength);
+                queue.push(neighbor);
+            }
+        }
+        evaluations.clear();
+    }
+    return expansions;
+}
+
+void ArrtsEngine::_publishPath(ConfigspaceGraph& configGraph, unsigned long goalId, PlannerHandle& handle)
+{
+    double cost = configGraph.nodes[goalId].cost();
+    if (cost >= handle.bestCost())
+        return;
+
+    vector<State> path;
+    for (unsigned long id = goalId; id; id = configGraph.nodes[id].parentId())
+        path.push_back(configGraph.nodes[id]);
+    handle.publish(path, cost);
+}
+
+bool ArrtsEngine::_stopRequested(ArrtsParams& params, PlannerHandle* handle, steady_clock::time_point deadline, int count)
 {
-    if (n1.cost() < (n2.cost() + configGraph.computeCost(n1, n2)))
+    if (handle && handle->isCancelled())
+    {
+        printf("Planning cancelled after %d samples\n", count);
+        return true;
+    }
+    if (steady_clock::now() >= deadline)
+    {
+        printf("Time budget of %.1f ms reached after %d samples\n", params.timeBudgetMs(), count);
         return true;
+    }
     return false;
 }
 
-void ArrtsEngine::runArrtsOnGraphs(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, ArrtsParams params, ManeuverType maneuverType)
+bool ArrtsEngine::_interrupted(PlannerHandle* handle, steady_clock::time_point deadline)
+{
+    return (handle && handle->isCancelled()) || steady_clock::now() >= deadline;
+}
+
+void ArrtsEngine::_runInParallel(int numItems, int numThreads, const function<void(int, int)>& work)
+{
+    // workers take items off a shared counter, since extensions that reach the rewiring stage
+    // cost far more than rejected ones; the calling thread is worker 0
+    atomic<int> next(0);
+    auto runWorker = [&](int worker) {
+        for (int i = next++; i < numItems; i = next++)
+            work(worker, i);
+    };
+
+    vector<thread> workers;
+    for (int t = 1; t < min(numThreads, numItems); ++t)
+        workers.emplace_back(runWorker, t);
+    runWorker(0);
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void ArrtsEngine::_evaluateCandidate(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, ExpansionCandidate& candidate, ManeuverEvaluationCache& evaluations)
+{
+    // the same steps as a serial iteration, except that the graph is only read: the best safe
+    // parent among the neighbors, then the neighbors that would be cheaper through the new node
+    auto& newNode = candidate.node;
+    auto parentNode = configGraph.nodes[newNode.parentId()];
+    vector<ConfigspaceNode> neighbors;
+    for (auto id : candidate.neighborIds)
+        neighbors.push_back(configGraph.nodes[id]);
+    _tryConnectToBestNeighbor(configGraph, workGraph, neighbors, newNode, parentNode, evaluations);
+
+    candidate.rewires.clear();
+    for (auto& rn : neighbors)
+    {
+        if (rn.cost() < newNode.cost() + configGraph.computeCostLowerBound(rn, newNode))
+            continue;
+        double pathLength = configGraph.computeCost(rn, newNode, &evaluations);
+        if (rn.cost() > newNode.cost() + pathLength && evaluations.evaluate(rn, newNode).isSafe(workGraph))
+            candidate.rewires.push_back({ rn.id(), pathLength });
+    }
+}
+
+void ArrtsEngine::_commitCandidate(ConfigspaceGraph& configGraph, ExpansionCandidate& candidate)
+{
+    // earlier commits may have lowered the parent's cost since the candidate was evaluated
+    auto newNode = candidate.node;
+    auto& parentNode = configGraph.nodes[newNode.parentId()];
+    newNode.setCost(parentNode.cost() + newNode.pathLength());
+
+    int id = configGraph.addNode(newNode);
+    newNode = configGraph.nodes[id];
+    configGraph.addEdge(parentNode, newNode);
+
+    // a rewire is only kept if it still lowers the cost, which also rules out cycles since
+    // costs strictly increase away from the root
+    for (auto& rewire : candidate.rewires)
+    {
+        auto rn = configGraph.nodes[rewire.first];
+        if (rn.cost() <= newNode.cost() + rewire.second)
+            continue;
+
+        auto rewired = rn;
+        rewired.setParentId(id);
+        rewired.setPathLength(rewire.second);
+        rewired.setCost(newNode.cost() + rewire.second);
+
+        configGraph.removeEdge(rn.parentId(), rn.id());
+        configGraph.addEdge(newNode, rewired);
+        configGraph.replaceNode(rn, rewired);
+        configGraph.propagateCost(rn.id());
+    }
+}
+
+int ArrtsEngine::_expandInBatches(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, ArrtsParams& params, double epsilon, int numThreads, steady_clock::time_point deadline, PlannerHandle* handle)
+{
+    int count = 0;
+    int goalBiasCount = (int)ceil(params.minNodeCount() * 0.01);
+    const GoalNodeSet& goalNodes = configGraph.goalNodes();
+    vector<ManeuverEvaluationCache> evaluations(numThreads);
+    vector<ConfigspaceNode> samples, extended;
+    vector<ExpansionCandidate> candidates;
+    vector<char> isValid;
+
+    while (goalNodes.bestId() == 0 || count < params.minNodeCount())
+    {
+        if (_stopRequested(params, handle, deadline, count))
+            break;
+
+        // samples in a batch can't see each other, so batches stay small next to the tree
+        int batchSize = max(numThreads, min(numThreads * PARALLEL_BATCH_SAMPLES_PER_THREAD, (int)configGraph.nodes.size() / PARALLEL_BATCH_TREE_FRACTION));
+
+        // samples are drawn on this thread, so a seeded run is the same for any thread count
+        samples.clear();
+        for (int i = 0; i < batchSize; ++i)
+        {
+            _printProgress(count, params.minNodeCount());
+            samples.push_back((count++ % goalBiasCount != 0)
+                ? configGraph.generateRandomNode()
+                : configGraph.generateBiasedNode(workGraph.goalRegion()));
+        }
+
+        // nothing writes to the graph until the commits, so the workers read it without locks
+        auto parentIds = configGraph.findClosestParentIds(samples, numThreads);
+        extended.assign(batchSize, ConfigspaceNode());
+        isValid.assign(batchSize, false);
+        _runInParallel(batchSize, numThreads, [&](int worker, int i) {
+            auto& parentNode = configGraph.nodes[parentIds[i]];
+            if (goalNodes.contains(parentNode.id()))
+                return;
+
+            evaluations[worker].clear();
+            extended[i] = configGraph.extendToNode(parentNode, samples[i], epsilon, &evaluations[worker]);
+            isValid[i] = workGraph.nodeIsSafe(extended[i]) && evaluations[worker].evaluate(extended[i], parentNode).isSafe(workGraph);
+        });
+        if (_interrupted(handle, deadline))
+            continue;
+
+        candidates.clear();
+        for (int i = 0; i < batchSize; ++i)
+            if (isValid[i])
+                candidates.push_back({ extended[i], {}, {} });
+
+        vector<ConfigspaceNode> centerNodes;
+        for (auto& candidate : candidates)
+            centerNodes.push_back(candidate.node);
+        auto neighborIds = configGraph.findNeighborIds(centerNodes, epsilon, params.maxNeighborCount(), numThreads);
+        for (size_t i = 0; i < candidates.size(); ++i)
+            candidates[i].neighborIds = move(neighborIds[i]);
+
+        _runInParallel(candidates.size(), numThreads, [&](int worker, int i) {
+            evaluations[worker].clear();
+            _evaluateCandidate(configGraph, workGraph, candidates[i], evaluations[worker]);
+        });
+
+        // a batch that ran past the deadline is dropped rather than committed late
+        if (_interrupted(handle, deadline))
+            continue;
+
+        // commits are applied on this thread in sample order
+        for (auto& candidate : candidates)
+            _commitCandidate(configGraph, candidate);
+
+        if (handle && goalNodes.bestId())
+            _publishPath(configGraph, goalNodes.bestId(), *handle);
+    }
+    return count;
+}
+
+unsigned long ArrtsEngine::runArrtsOnGraphs(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, ArrtsParams params, ManeuverType maneuverType, PlannerHandle* handle)
 {
     ConfigspaceNode tempNode, parentNode, newNode;
     vector<ConfigspaceNode> neighbors;
+    ManeuverEvaluationCache evaluations;
+    LookaheadQueue queue;
     bool goalRegionReached = false;
+    bool rrtSharp = params.engineMode() == RrtSharpMode;
+    unsigned long expansions = 0;
 
     int count = 0, tempId = 0;
     int goalBiasCount = (int)ceil(params.minNodeCount() * 0.01);
     double epsilonToVolRatio = 0.00001;
     double epsilon = workGraph.volume() * epsilonToVolRatio;
     ManeuverEngine::maneuverType = maneuverType;
+    ManeuverEvaluation::resetStats();
+    ManeuverEngine::maneuverCache().setCapacity(params.maneuverCacheBytes());
+    ManeuverEngine::setMaxSampleStep(params.maxSampleStep());
+    ManeuverEngine::maneuverCache().resetStats();
+    workGraph.resetSampleStats();
+
+    // the same tolerance as WorkspaceGraph::checkAtGoal
+    GoalState goalRegion = workGraph.goalRegion();
+    double goalTolerance = goalRegion.radius() + workGraph.vehicle().boundingRadius();
+    configGraph.setGoalRegion(goalRegion, goalTolerance);
+    const GoalNodeSet& goalNodes = configGraph.goalNodes();
+
+    // the graph is consistent to begin with, so every node's lookahead is its own cost
+    queue.setGoal(goalRegion, goalTolerance);
+    for (auto& node : configGraph.nodes)
+        queue.relax(node.id(), node.cost(), node.parentId(), node.pathLength());
+
+    int numThreads = params.numThreads() > 0 ? params.numThreads() : max(1, (int)thread::hardware_concurrency());
+    if (rrtSharp && numThreads != 1)
+    {
+        printf("WARN: RRT# mode expands one sample at a time, ignoring %d threads\n", numThreads);
+        numThreads = 1;
+    }
 
-    srand(time(NULL));
+    srand(params.randomSeed() != TIME_RANDOM_SEED ? params.randomSeed() : time(NULL));
 
     printf("Using %s Maneuvers\n", maneuverType == DirectPath ? "DirectPath" : "Dubins3d");
+    printf("Engine mode: %s\n", rrtSharp ? "RRT#" : "RRT*");
     printf("Epsilon/Volume ratio: %f\n", epsilon / workGraph.volume());
     printf("Epsilon: %f\n", epsilon);
+    printf("Max sample step: %f\n", ManeuverEngine::maxSampleStep());
+    printf("Threads: %d\n", numThreads);
 
-    while(!goalRegionReached || count < params.minNodeCount())
+    // without a budget the deadline never passes
+    auto deadline = params.timeBudgetMs() != NO_TIME_BUDGET
+        ? steady_clock::now() + duration_cast<steady_clock::duration>(duration<double, milli>(params.timeBudgetMs()))
+        : steady_clock::time_point::max();
+
+    // with several threads RRT* expands in batches; otherwise every sample is expanded in turn
+    if (numThreads != 1)
+        count = _expandInBatches(configGraph, workGraph, params, epsilon, numThreads, deadline, handle);
+
+    while(numThreads == 1 && (!goalRegionReached || count < params.minNodeCount()))
     {
+        if (_stopRequested(params, handle, deadline, count))
+            break;
+
         _printProgress(count, params.minNodeCount());
+        evaluations.clear();
 
         // create a new node (not yet connected to the graph)
         tempNode = (count++ % goalBiasCount != 0)
@@ -121,29 +429,61 @@ void ArrtsEngine::runArrtsOnGraphs(ConfigspaceGraph& configGraph, WorkspaceGraph
         parentNode = configGraph.findClosestParentNode(tempNode);
 
         // skip if the parent node is already in the goal region
-        if (!workGraph.checkAtGoal(parentNode))
+        if (!goalNodes.contains(parentNode.id()))
         {
             // create a new node by extending from the parent to the temp node; then compute cost
-            newNode = configGraph.extendToNode(parentNode, tempNode, epsilon);
+            newNode = configGraph.extendToNode(parentNode, tempNode, epsilon, &evaluations);
 
-            if (workGraph.nodeIsSafe(newNode) && workGraph.pathIsSafe(newNode, parentNode))
+            if (workGraph.nodeIsSafe(newNode) && evaluations.evaluate(newNode, parentNode).isSafe(workGraph))
             {
                 neighbors = configGraph.findNeighbors(newNode, epsilon, params.maxNeighborCount());
-                _tryConnectToBestNeighbor(configGraph, workGraph, neighbors, newNode, parentNode);
+                _tryConnectToBestNeighbor(configGraph, workGraph, neighbors, newNode, parentNode, evaluations);
 
                 // add new node and edge to the config graph
                 tempId = configGraph.addNode(newNode);
                 newNode = configGraph.nodes.at(tempId);
                 configGraph.addEdge(parentNode, newNode);
 
-                // if we haven't reached the goal yet and the added node is in the
-                // goal region, then set goalRegionReached to true
-                if (!goalRegionReached && workGraph.checkAtGoal(newNode))
+                // if the added node is in the goal region, then set goalRegionReached to true
+                if (goalNodes.contains(newNode.id()))
                     goalRegionReached = true;
 
-                // do the rewiring while there are nodes left in remainingNodes
-                _rewireNodes(configGraph, workGraph, neighbors, newNode);
+                if (rrtSharp)
+                {
+                    // the new node is consistent; it is expanded like any other queued node
+                    queue.relax(newNode.id(), newNode.cost(), newNode.parentId(), newNode.pathLength());
+                    if (newNode.cost() + queue.costToGoalLowerBound(newNode) < goalNodes.bestCost())
+                        queue.push(newNode);
+                    expansions += _replan(configGraph, workGraph, queue, epsilon, params.maxNeighborCount(), evaluations, deadline, handle);
+                }
+                else
+                {
+                    // do the rewiring while there are nodes left in remainingNodes
+                    _rewireNodes(configGraph, workGraph, neighbors, newNode, evaluations);
+                }
+
+                // the new node or a cost lowered by rewiring may have improved the best path
+                if (handle && goalNodes.bestId())
+                    _publishPath(configGraph, goalNodes.bestId(), *handle);
             }
         }
     }
+
+    auto stats = ManeuverEvaluation::stats();
+    printf("Maneuver requests: %lu, constructed: %lu, eliminated: %lu\n", stats.requests, stats.constructions, stats.requests - stats.constructions);
+
+    double numPaths = max(workGraph.pathsChecked(), 1ul);
+    printf("Paths checked: %lu, samples: %lu (%.1f per path), bounds: %lu (%.1f per path)\n", workGraph.pathsChecked(),
+        workGraph.samplesChecked(), workGraph.samplesChecked() / numPaths, workGraph.boundsChecked(), workGraph.boundsChecked() / numPaths);
+    printf("Paths rejected: %lu (%.1f samples to reject)\n", workGraph.pathsRejected(),
+        workGraph.rejectionSamples() / (double)max(workGraph.pathsRejected(), 1ul));
+
+    if (rrtSharp)
+        printf("RRT# expansions: %lu, still queued: %lu\n", expansions, queue.size());
+
+    auto cacheStats = ManeuverEngine::maneuverCache().stats();
+    printf("Maneuver cache hits: %lu, misses: %lu, evictions: %lu, entries: %lu (%.1f MB)\n",
+        cacheStats.hits, cacheStats.misses, cacheStats.evictions, cacheStats.entries, cacheStats.bytes / 1e6);
+
+    return goalNodes.bestId();
 }
\ No newline at end of file
@@ -1,28 +1,71 @@
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
 #include <vector>
 #include "ArrtsParams.hpp"
 #include "ConfigspaceGraph.hpp"
 #include "ConfigspaceNode.hpp"
 #include "ManeuverEngine.hpp"
+#include "ManeuverEvaluation.hpp"
 #include "Geometry2D.hpp"
 #include "Geometry3D.hpp"
+#include "LookaheadQueue.hpp"
+#include "PlannerHandle.hpp"
 #include "WorkspaceGraph.hpp"
 
 #ifndef ARRTS_ENGINE_H
 #define ARRTS_ENGINE_H
 
 #define REPORTING_PERCENTILE 5
+#define PARALLEL_BATCH_SAMPLES_PER_THREAD 16    // upper bound on samples each thread expands per batch
+#define PARALLEL_BATCH_TREE_FRACTION 64         // a batch is at most this fraction of the tree
 
 using namespace std;
+using namespace std::chrono;
+
+// a sample extended in a parallel batch, along with the rewires it would make once added
+struct ExpansionCandidate
+{
+    ConfigspaceNode node;
+    vector<unsigned long> neighborIds;
+    vector<pair<unsigned long, double>> rewires;    // neighbor id and path length from the node
+};
 
 class ArrtsEngine
 {
     static void _printProgress(int count, int minCount);
-    static void _rewireNodes(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, vector<ConfigspaceNode>& remainingNodes, ConfigspaceNode& addedNode);
-    static void _tryConnectToBestNeighbor(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, vector<ConfigspaceNode>& neighbors, ConfigspaceNode& newNode, ConfigspaceNode& parentNode);
-    static bool _compareNodes(ConfigspaceGraph& configGraph, ConfigspaceNode& n1, ConfigspaceNode& n2);
+    static void _rewireNodes(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, vector<ConfigspaceNode>& remainingNodes, ConfigspaceNode& addedNode, ManeuverEvaluationCache& evaluations);
+    static void _tryConnectToBestNeighbor(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, vector<ConfigspaceNode>& neighbors, ConfigspaceNode& newNode, ConfigspaceNode& parentNode, ManeuverEvaluationCache& evaluations);
+    static bool _compareNodes(ConfigspaceGraph& configGraph, ConfigspaceNode& n1, ConfigspaceNode& n2, ManeuverEvaluationCache& evaluations);
+
+    // RRT# mode: rewires the node to its lookahead parent if that is cheaper than its cost
+    static void _applyLookahead(ConfigspaceGraph& configGraph, LookaheadQueue& queue, ConfigspaceNode& node);
+
+    // RRT# mode: expands queued nodes until none can lead to a goal node cheaper than the best one,
+    // or until planning is interrupted; nodes left queued are expanded by the next call
+    static unsigned long _replan(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, LookaheadQueue& queue, double epsilon, int maxNeighborCount, ManeuverEvaluationCache& evaluations, steady_clock::time_point deadline, PlannerHandle* handle);
+
+    static void _publishPath(ConfigspaceGraph& configGraph, unsigned long goalId, PlannerHandle& handle);
+    static bool _stopRequested(ArrtsParams& params, PlannerHandle* handle, steady_clock::time_point deadline, int count);
+    static bool _interrupted(PlannerHandle* handle, steady_clock::time_point deadline);
+
+    // parallel mode: work(worker, item) is called once per item, with workers numbered from 0
+    static void _runInParallel(int numItems, int numThreads, const function<void(int, int)>& work);
+    static void _evaluateCandidate(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, ExpansionCandidate& candidate, ManeuverEvaluationCache& evaluations);
+    static void _commitCandidate(ConfigspaceGraph& configGraph, ExpansionCandidate& candidate);
+
+    // parallel mode: workers extend and rewire a batch of samples against the unchanged graph,
+    // then the results are added to it on the calling thread. returns the number of samples
+    static int _expandInBatches(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, ArrtsParams& params, double epsilon, int numThreads, steady_clock::time_point deadline, PlannerHandle* handle);
 
     public:
-        static void runArrtsOnGraphs(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, ArrtsParams params, ManeuverType maneuverType);
+        // returns the id of the cheapest node in the goal region, or 0 if planning stopped before
+        // reaching it. with a handle, improved paths are published to it as they are found and
+        // planning stops once it is cancelled. the budget and the handle are checked before every
+        // sample, every RRT# expansion and every stage of a parallel batch, so planning overruns
+        // the budget by at most one such step; it is not a hard real-time limit
+        static unsigned long runArrtsOnGraphs(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, ArrtsParams params, ManeuverType maneuverType, PlannerHandle* handle = nullptr);
 
 };
 
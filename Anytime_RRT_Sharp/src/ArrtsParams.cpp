@@ -2,6 +2,7 @@
 
 ArrtsParams::ArrtsParams(State start, State goal, vector<Shape3d*> obstacles, double goalRadius, int minNodeCount, int maxNieghborCount)
 {
+    _buildDefaultParams();
     _start = start;
     _goal = goal;
     _obstacles = obstacles;
@@ -16,6 +17,7 @@ ArrtsParams::ArrtsParams(State start, State goal, vector<Shape3d*> obstacles, do
 ArrtsParams::ArrtsParams(string dataDirectory, int minNodeCount, int maxNieghborCount)
 {
     printf("Initializing data from %s\n", dataDirectory.c_str());
+    _buildDefaultParams();
 
     string statesFile = dataDirectory + "/" + DEFAULT_STATES_FILE;
     string vehicleFile = dataDirectory + "/" + DEFAULT_VEHICLE_FILE;
@@ -30,6 +32,20 @@ ArrtsParams::ArrtsParams(string dataDirectory, int minNodeCount, int maxNieghbor
     _removeObstaclesNotInLimits();
 }
 
+void ArrtsParams::_buildDefaultParams()
+{
+    _nodeIndexType = KdTreeIndex;
+    _engineMode = RrtStarMode;
+    _randomSeed = TIME_RANDOM_SEED;
+    _timeBudgetMs = NO_TIME_BUDGET;
+    _numThreads = DEFAULT_NUM_THREADS;
+    _neighborApproximationError = DEFAULT_NEIGHBOR_APPROXIMATION_ERROR;
+    _maneuverCacheBytes = DEFAULT_MANEUVER_CACHE_BYTES;
+    _maxSampleStep = AUTO_MAX_SAMPLE_STEP;
+    _distanceFieldResolution = DEFAULT_DISTANCE_FIELD_RESOLUTION;
+    _distanceFieldFile = "";
+}
+
 void ArrtsParams::_setLimitsFromStates()
 {
     double minX, maxX, minY, maxY, minZ, maxZ;
@@ -141,6 +157,57 @@ int ArrtsParams::minNodeCount() { return _minNodeCount; }
 
 int ArrtsParams::maxNeighborCount() { return _maxNeighborCount; }
 
+NodeIndexType ArrtsParams::nodeIndexType() { return _nodeIndexType; }
+
+void ArrtsParams::setNodeIndexType(NodeIndexType type) { _nodeIndexType = type; }
+
+EngineMode ArrtsParams::engineMode() { return _engineMode; }
+
+void ArrtsParams::setEngineMode(EngineMode mode) { _engineMode = mode; }
+
+unsigned int ArrtsParams::randomSeed() { return _randomSeed; }
+
+void ArrtsParams::setRandomSeed(unsigned int seed) { _randomSeed = seed; }
+
+double ArrtsParams::timeBudgetMs() { return _timeBudgetMs; }
+
+void ArrtsParams::setTimeBudgetMs(double budgetMs) { _timeBudgetMs = budgetMs; }
+
+int ArrtsParams::numThreads() { return _numThreads; }
+
+void ArrtsParams::setNumThreads(int numThreads) { _numThreads = numThreads; }
+
+double ArrtsParams::neighborApproximationError() { return _neighborApproximationError; }
+
+void ArrtsParams::setNeighborApproximationError(double epsilon) { _neighborApproximationError = epsilon; }
+
+unsigned long ArrtsParams::maneuverCacheBytes() { return _maneuverCacheBytes; }
+
+void ArrtsParams::setManeuverCacheBytes(unsigned long bytes) { _maneuverCacheBytes = bytes; }
+
+double ArrtsParams::maxSampleStep()
+{
+    if (_maxSampleStep >= 0)
+        return _maxSampleStep;
+
+    // without obstacles there is nothing to derive a spacing from
+    double minWidth = INFINITY;
+    for (auto o : _obstacles)
+        if (o->minWidth() > 0)
+            minWidth = min(minWidth, o->minWidth());
+    return isinf(minWidth) ? 0 : minWidth * SAMPLE_STEP_OBSTACLE_WIDTH_RATIO;
+}
+
+void ArrtsParams::setMaxSampleStep(double step) { _maxSampleStep = step; }
+
+double ArrtsParams::distanceFieldResolution() { return _distanceFieldResolution; }
+
+void ArrtsParams::setDistanceFieldResolution(double resolution) { _distanceFieldResolution = resolution; }
+
+string ArrtsParams::distanceFieldFile() { return _distanceFieldFile; }
+
+void ArrtsParams::setDistanceFieldFile(string fileName) { _distanceFieldFile = fileName; }
+
 double ArrtsParams::goalRadius() { return _goalRadius; }
 
 double ArrtsParams::obstacleVolume() { return _obstacleVolume; }
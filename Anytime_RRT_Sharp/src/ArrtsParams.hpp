@@ -5,6 +5,8 @@
 #include "cppshrhelp.hpp"
 #include "Geometry2D.hpp"
 #include "Geometry3D.hpp"
+#include "ManeuverCache.hpp"
+#include "NodeIndex.hpp"
 #include "Vehicle.hpp"
 
 #ifndef ARRTS_PARAMS_H
@@ -14,20 +16,39 @@
 #define DEFAULT_VEHICLE_FILE "robot.txt"
 #define DEFAULT_OBSTACLES_FILE "obstacles.txt"
 #define DEFAULT_MIN_NODE_COUNT 20000
-#define DEFAULT_MAX_NEIGHBOR_COUNT 15
+#define DEFAULT_MAX_NEIGHBOR_COUNT 10
+#define DEFAULT_NEIGHBOR_APPROXIMATION_ERROR 0  // exact nearest-neighbor queries
+#define AUTO_MAX_SAMPLE_STEP -1                 // derive the path sample spacing from the obstacles
+#define SAMPLE_STEP_OBSTACLE_WIDTH_RATIO 0.25   // derived spacing as a fraction of the thinnest obstacle
+#define DEFAULT_DISTANCE_FIELD_RESOLUTION 0     // no distance field
+#define TIME_RANDOM_SEED 0                      // seed the sampler from the clock
+#define NO_TIME_BUDGET 0                        // plan until the node count and goal are reached
+#define DEFAULT_NUM_THREADS 1                   // expand one sample at a time; 0 uses every hardware thread
 #define DIMENSION 3
 
 using namespace std;
 
+enum EngineMode
+{
+    RrtStarMode,    // rewires the neighbors of each added node and propagates every cost change
+    RrtSharpMode    // queues inconsistent vertices and only replans the ones that can improve the goal
+};
+
  class DLL_EXPORT ArrtsParams
  {
-   int _minNodeCount, _maxNeighborCount;
-   double _goalRadius, _obstacleVolume;
+   int _minNodeCount, _maxNeighborCount, _numThreads;
+   NodeIndexType _nodeIndexType;
+   EngineMode _engineMode;
+   double _goalRadius, _obstacleVolume, _neighborApproximationError, _maxSampleStep, _distanceFieldResolution, _timeBudgetMs;
+   string _distanceFieldFile;
+   unsigned long _maneuverCacheBytes;
+   unsigned int _randomSeed;
    State _start, _goal;
    Rectangle _limits;
    Vehicle _vehicle;
    vector<Shape3d*> _obstacles;
 
+   void _buildDefaultParams();
    void _setLimitsFromStates();
    void _removeObstaclesNotInLimits();
    void _calculateObstacleVolume();
@@ -42,6 +63,40 @@ using namespace std;
       int dimension();
       int minNodeCount();
       int maxNeighborCount();
+      NodeIndexType nodeIndexType();
+      void setNodeIndexType(NodeIndexType type);
+      EngineMode engineMode();
+      void setEngineMode(EngineMode mode);
+
+      // seed of the node sampler; TIME_RANDOM_SEED seeds it from the clock on every run
+      unsigned int randomSeed();
+      void setRandomSeed(unsigned int seed);
+
+      // wall clock time the engine may plan for; it stops at the budget even if the node count
+      // or the goal hasn't been reached. NO_TIME_BUDGET plans until both are
+      double timeBudgetMs();
+      void setTimeBudgetMs(double budgetMs);
+
+      // threads expanding the tree in RRT* mode; more than one expands samples in batches, so
+      // the tree differs from a single threaded run with the same seed
+      int numThreads();
+      void setNumThreads(int numThreads);
+      double neighborApproximationError();
+      void setNeighborApproximationError(double epsilon);
+      unsigned long maneuverCacheBytes();
+      void setManeuverCacheBytes(unsigned long bytes);
+
+      // maximum distance between path samples checked for safety; 0 samples every path at a
+      // fixed count and AUTO_MAX_SAMPLE_STEP derives it from the thinnest obstacle
+      double maxSampleStep();
+      void setMaxSampleStep(double step);
+
+      // vertex spacing of the workspace distance field, or 0 to check obstacles directly; with
+      // a file the field is loaded from it when it matches and saved to it after a build
+      double distanceFieldResolution();
+      void setDistanceFieldResolution(double resolution);
+      string distanceFieldFile();
+      void setDistanceFieldFile(string fileName);
       double goalRadius();
       double obstacleVolume();
       State start();
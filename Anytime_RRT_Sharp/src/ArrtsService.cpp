@@ -7,24 +7,10 @@ void ArrtsService::_buildDefaultService()
     _workspaceGraph = WorkspaceGraph();
 }
 
-void ArrtsService::_setFinalNode()
+void ArrtsService::_setFinalNode(unsigned long finalNodeId)
 {
-    double tempCost = 0, finalCost = INFINITY;
-    ConfigspaceNode finalNode;
-    
-    for (auto itr = _configspaceGraph.nodes.begin(); itr != _configspaceGraph.nodes.end(); ++itr)
-    {
-        if (_workspaceGraph.checkAtGoal(itr->second))
-        {
-            tempCost = itr->second.cost();
-            if (tempCost)
-            {
-                finalCost = tempCost;
-                finalNode = itr->second;
-            }
-        }
-    }
-    _finalNode = finalNode;
+    // the engine keeps track of the cheapest goal node, so no search is needed
+    _finalNode = finalNodeId ? _configspaceGraph.nodes[finalNodeId] : ConfigspaceNode();
 }
 
 void ArrtsService::_setFinalPathFromFinalNode()
@@ -32,6 +18,8 @@ void ArrtsService::_setFinalPathFromFinalNode()
     auto node = _finalNode;
 
     _path.clear();
+    if (!node.id())
+        return;
     _path.push_back(node);
 
     while (node.parentId())
@@ -49,15 +37,60 @@ void ArrtsService::_configureWorkspace(ArrtsParams params)
     _workspaceGraph.defineFreespace(params.limits());
     _workspaceGraph.addObstacles(params.obstacles());
     _workspaceGraph.setVehicle(params.vehicle());
+
+    if (params.distanceFieldResolution() > 0)
+        _configureDistanceField(params);
+}
+
+void ArrtsService::_configureDistanceField(ArrtsParams params)
+{
+    string fileName = params.distanceFieldFile();
+    double resolution = params.distanceFieldResolution();
+
+    // a saved field is only reused if it was sampled from the same obstacles over the same limits
+    // at the same resolution; a file that can't be read is rebuilt like one that doesn't match
+    if (!fileName.empty() && ifstream(fileName).good())
+    {
+        DistanceField field;
+        bool isUsable = false;
+        try
+        {
+            field.load(fileName);
+            isUsable = field.covers(params.limits(), resolution, _workspaceGraph.obstacleFingerprint());
+        }
+        catch (const exception& e)
+        {
+            printf("WARN: %s\n", e.what());
+        }
+
+        if (isUsable)
+        {
+            _workspaceGraph.setDistanceField(move(field));
+            printf("Loaded distance field from %s\n", fileName.c_str());
+            return;
+        }
+        printf("WARN: Distance field in %s doesn't match the workspace, rebuilding...\n", fileName.c_str());
+    }
+
+    auto startTime = high_resolution_clock::now();
+    _workspaceGraph.buildDistanceField(resolution);
+    auto buildTime = duration_cast<milliseconds>(high_resolution_clock::now() - startTime);
+    printf("Built distance field: %lu vertices (%.1f MB) in %lld ms\n", _workspaceGraph.distanceField().size(),
+        _workspaceGraph.distanceField().bytes() / 1e6, (long long)buildTime.count());
+
+    if (!fileName.empty())
+        _workspaceGraph.distanceField().save(fileName);
 }
 
 void ArrtsService::_configureConfigspace(ArrtsParams params)
 {
     _configspaceGraph.defineFreespace(params.limits(), params.dimension(), params.obstacleVolume());
+    _configspaceGraph.setNodeIndexType(params.nodeIndexType());
+    _configspaceGraph.setNeighborApproximationError(params.neighborApproximationError());
     _configspaceGraph.setRootNode(params.start());
 }
 
-void ArrtsService::_runAlgorithm(ArrtsParams params, ManeuverType maneuverType)
+void ArrtsService::_runAlgorithm(ArrtsParams params, ManeuverType maneuverType, PlannerHandle* handle)
 {
     printf("ObsVol: %f, NumObs: %lu\n", params.obstacleVolume(), params.obstacles().size());
     printf("Freespace Min: [%f, %f, %f], Freespace Max: [%f, %f, %f]\n", params.limits().minPoint().x(), params.limits().minPoint().y(), params.limits().minPoint().z(), params.limits().maxPoint().x(), params.limits().maxPoint().y(), params.limits().maxPoint().z());
@@ -65,18 +98,28 @@ void ArrtsService::_runAlgorithm(ArrtsParams params, ManeuverType maneuverType)
     printf("Root Position: [%f, %f, %f], Root Orientation [%f, %f]\n", params.start().x(), params.start().y(), params.start().z(), params.start().theta(), params.start().rho());
     auto start = high_resolution_clock::now();
 
-    ArrtsEngine::runArrtsOnGraphs(_configspaceGraph, _workspaceGraph, params, maneuverType);
+    auto finalNodeId = ArrtsEngine::runArrtsOnGraphs(_configspaceGraph, _workspaceGraph, params, maneuverType, handle);
 
     auto stop = high_resolution_clock::now();
     auto duration = duration_cast<milliseconds>(stop - start);
 
-    _setFinalNode();
+    _setFinalNode(finalNodeId);
     _setFinalPathFromFinalNode();
 
+    if (!finalNodeId)
+        printf("WARN: The goal region was not reached\n");
+
     printf("Total number of points: %lu\n", _configspaceGraph.nodes.size());
     printf("Final Position: [%f, %f, %f]\n", _finalNode.x(), _finalNode.y(), _finalNode.z());
     printf("Final Cost: %f\n", _finalNode.cost());
     printf("Total Runtime: %lld ms\n", duration.count());
+
+    if (_configspaceGraph.neighborApproximationError() > 0)
+    {
+        auto stats = _configspaceGraph.approximateQueryStats();
+        double inexactRate = stats.audited ? 100.0 * stats.inexact / stats.audited : 0;
+        printf("Approximate NN Queries: %lu, Audited: %lu, Inexact: %lu (%.1f%%)\n", stats.queries, stats.audited, stats.inexact, inexactRate);
+    }
 }
 
 vector<State> ArrtsService::calculatePath(ArrtsParams params, string dataExportDir, ManeuverType maneuverType)
@@ -84,7 +127,18 @@ vector<State> ArrtsService::calculatePath(ArrtsParams params, string dataExportD
     _buildDefaultService();
     _configureWorkspace(params);
     _configureConfigspace(params);
-    _runAlgorithm(params, maneuverType);
+    _runAlgorithm(params, maneuverType, nullptr);
+    _exportDataToDirectory(dataExportDir);
+
+    return _path;
+}
+
+vector<State> ArrtsService::calculatePath(ArrtsParams params, string dataExportDir, ManeuverType maneuverType, PlannerHandle& handle)
+{
+    _buildDefaultService();
+    _configureWorkspace(params);
+    _configureConfigspace(params);
+    _runAlgorithm(params, maneuverType, &handle);
     _exportDataToDirectory(dataExportDir);
 
     return _path;
@@ -111,13 +165,14 @@ void ArrtsService::_exportDataToDirectory(string directory)
     _printEdgesToFileStream(_configspaceGraph.edges, edgeFile);
     _printSearchTreeToFileStream(_configspaceGraph.edges, searchTreeFile);
 
-    // print out output path
+    // print out output path; the sampled maneuvers are regenerated from the node states
     ConfigspaceNode currentNode = _configspaceGraph.nodes[_finalNode.id()];
     while (currentNode.parentId())
     {
-        _printStatesToFileStream(currentNode.pathTo(), fullOutputPathFile);
+        auto& parentNode = _configspaceGraph.nodes.at(currentNode.parentId());
+        _printStatesToFileStream(currentNode.generatePathFrom(parentNode), fullOutputPathFile);
         _printStateToFileStream(currentNode, outputPathFile);
-        currentNode = _configspaceGraph.nodes.at(currentNode.parentId());
+        currentNode = parentNode;
     }
     _printStateToFileStream(_configspaceGraph.nodes.at(1), outputPathFile);
     _printStateToFileStream(_configspaceGraph.nodes.at(1), fullOutputPathFile);
@@ -135,10 +190,10 @@ void ArrtsService::_exportDataToDirectory(string directory)
     fullOutputPathFile.close();
 }
 
-void ArrtsService::_printGraphNodesToFileStream(const unordered_map<unsigned long, ConfigspaceNode>& nodeMap, ofstream& fileStream) const
+void ArrtsService::_printGraphNodesToFileStream(const NodeArena& nodes, ofstream& fileStream) const
 {
-    for (auto itr = nodeMap.begin(); itr != nodeMap.end(); ++itr)
-        _printGraphNodeToFileStream(itr->second, fileStream);
+    for (auto& node : nodes)
+        _printGraphNodeToFileStream(node, fileStream);
 }
 
 void ArrtsService::_printStatesToFileStream(const vector<State>& states, ofstream& fileStream) const
@@ -179,4 +234,8 @@ void ArrtsService::_printFullEdgeToFileStream(const Edge& edge, ofstream& fileSt
 {
     fileStream << edge.start().id() << " " << edge.start().x() << " " << edge.start().y() << " " << edge.start().z() << " "
         << edge.end().id() << " " << edge.end().x() << " " << edge.end().y() << " " << edge.end().z() << endl;
-}
\ No newline at end of file
+}
+
+const ConfigspaceGraph& ArrtsService::configspaceGraph() const { return _configspaceGraph; }
+
+const WorkspaceGraph& ArrtsService::workspaceGraph() const { return _workspaceGraph; }
\ No newline at end of file
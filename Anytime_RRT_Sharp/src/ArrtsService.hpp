@@ -6,6 +6,7 @@
 #include "ConfigspaceGraph.hpp"
 #include "ConfigspaceNode.hpp"
 #include "ManeuverEngine.hpp"
+#include "PlannerHandle.hpp"
 #include "cppshrhelp.hpp"
 #include "Geometry2D.hpp"
 #include "Geometry3D.hpp"
@@ -26,14 +27,15 @@ class DLL_EXPORT ArrtsService
         ConfigspaceNode _finalNode;
 
         void _buildDefaultService();
-        void _setFinalNode();
+        void _setFinalNode(unsigned long finalNodeId);
         void _setFinalPathFromFinalNode();
         void _configureWorkspace(ArrtsParams params);
+        void _configureDistanceField(ArrtsParams params);
         void _configureConfigspace(ArrtsParams params);
-        void _runAlgorithm(ArrtsParams params, ManeuverType maneuverType);
+        void _runAlgorithm(ArrtsParams params, ManeuverType maneuverType, PlannerHandle* handle);
         void _exportDataToDirectory(string directory);
         
-        void _printGraphNodesToFileStream(const unordered_map<unsigned long, ConfigspaceNode>& nodeMap, ofstream& fileStream) const;
+        void _printGraphNodesToFileStream(const NodeArena& nodes, ofstream& fileStream) const;
         void _printStatesToFileStream(const vector<State>& states, ofstream& fileStream) const;
         void _printEdgesToFileStream(const vector<Edge> edges, ofstream& fileStream) const;
         void _printSearchTreeToFileStream(const vector<Edge> edges, ofstream& fileStream) const;
@@ -45,6 +47,12 @@ class DLL_EXPORT ArrtsService
 
     public:
         vector<State> DLL_EXPORT calculatePath(ArrtsParams params, string dataExportDir, ManeuverType maneuverType);
+
+        // anytime planning: improved paths are published to the handle while planning runs, and
+        // cancelling it returns the best path found so far. empty if the goal wasn't reached
+        vector<State> DLL_EXPORT calculatePath(ArrtsParams params, string dataExportDir, ManeuverType maneuverType, PlannerHandle& handle);
+        const ConfigspaceGraph& configspaceGraph() const;
+        const WorkspaceGraph& workspaceGraph() const;
 };
 
 #endif
\ No newline at end of file
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include "ConfigspaceGraph.hpp"
+#include "ManeuverEvaluation.hpp"
 
 double randInRange(double min, double max)
 {
@@ -15,20 +17,99 @@ void ConfigspaceGraph::buildGraph()
     minTheta = 0;
     maxTheta = 0;
     dim = 0;
+    _nodeIndexType = KdTreeIndex;
+    _neighborApproximationError = 0;
+    _nodeIndex.reset(NodeIndex::create(_nodeIndexType));
 }
 
+ConfigspaceGraph::ConfigspaceGraph(const ConfigspaceGraph& graph) : Rectangle(graph)
+{
+    *this = graph;
+}
+
+ConfigspaceGraph& ConfigspaceGraph::operator=(const ConfigspaceGraph& graph)
+{
+    Rectangle::operator=(graph);
+    _firstChildIds = graph._firstChildIds;
+    _nextSiblingIds = graph._nextSiblingIds;
+    _prevSiblingIds = graph._prevSiblingIds;
+    _goalNodes = graph._goalNodes;
+    _nodeIndex.reset(graph._nodeIndex->clone());
+    _nodeIndexType = graph._nodeIndexType;
+    _neighborApproximationError = graph._neighborApproximationError;
+    minTheta = graph.minTheta;
+    maxTheta = graph.maxTheta;
+    gamma_star = graph.gamma_star;
+    dim = graph.dim;
+    nodes = graph.nodes;
+    edges = graph.edges;
+    return *this;
+}
+
+void ConfigspaceGraph::setNodeIndexType(NodeIndexType type)
+{
+    _nodeIndexType = type;
+    _nodeIndex.reset(NodeIndex::create(type));
+    _nodeIndex->setApproximationError(_neighborApproximationError);
+    for (auto& node : nodes)
+        _nodeIndex->insert(node.id(), node);
+}
+
+NodeIndexType ConfigspaceGraph::nodeIndexType() const { return _nodeIndexType; }
+
+void ConfigspaceGraph::setGoalRegion(State goal, double tolerance)
+{
+    _goalNodes.setGoal(goal, tolerance);
+    for (auto& node : nodes)
+        _goalNodes.insert(node);
+}
+
+const GoalNodeSet& ConfigspaceGraph::goalNodes() const { return _goalNodes; }
+
+void ConfigspaceGraph::setNeighborApproximationError(double epsilon)
+{
+    _neighborApproximationError = epsilon;
+    _nodeIndex->setApproximationError(epsilon);
+}
+
+double ConfigspaceGraph::neighborApproximationError() const { return _neighborApproximationError; }
+
+ApproximateQueryStats ConfigspaceGraph::approximateQueryStats() const { return _nodeIndex->approximateQueryStats(); }
+
 void ConfigspaceGraph::_addParentChildRelation(unsigned long id)
 {
-    auto node = nodes[id];
-    _parentChildMap[node.parentId()].push_back(node.id());
+    unsigned long parentId = nodes[id].parentId();
+    unsigned long numSlots = max(id, parentId) + 1;
+    if (_firstChildIds.size() < numSlots)
+    {
+        _firstChildIds.resize(numSlots, 0);
+        _nextSiblingIds.resize(numSlots, 0);
+        _prevSiblingIds.resize(numSlots, 0);
+    }
+
+    // new children go to the front of their parent's list
+    unsigned long next = _firstChildIds[parentId];
+    _nextSiblingIds[id] = next;
+    _prevSiblingIds[id] = 0;
+    if (next)
+        _prevSiblingIds[next] = id;
+    _firstChildIds[parentId] = id;
 }
 
 void ConfigspaceGraph::_removeParentChildRelation(unsigned long id)
 {
-    auto node = nodes[id];
-    for (auto itr = _parentChildMap[node.parentId()].begin(); itr < _parentChildMap[node.parentId()].end(); ++itr)
-        if (*itr == id)
-            _parentChildMap[node.parentId()].erase(itr);
+    if (id >= _firstChildIds.size())
+        return;
+
+    unsigned long prev = _prevSiblingIds[id], next = _nextSiblingIds[id];
+    if (prev)
+        _nextSiblingIds[prev] = next;
+    else if (_firstChildIds[nodes[id].parentId()] == id)
+        _firstChildIds[nodes[id].parentId()] = next;
+    if (next)
+        _prevSiblingIds[next] = prev;
+    _nextSiblingIds[id] = 0;
+    _prevSiblingIds[id] = 0;
 }
 
 void ConfigspaceGraph::defineFreespace(Rectangle limits, int dimension, double obstacleVol)
@@ -117,57 +198,240 @@ double ConfigspaceGraph::_computeRadius(double epsilon) const
     return circleRadius;
 }
 
-ConfigspaceNode& ConfigspaceGraph::findClosestParentNode(GraphNode& node)
+unsigned long ConfigspaceGraph::_findClosestParentId(const GraphNode& node) const
 {
-    // initialize distance with first node
     // use euclidean distance of given node from existing nodes
-    double dist, shortestDist = INFINITY;
-    int closestNodeId = 0;
-
-    // track these in unordered map?
-    for (auto itr = nodes.begin(); itr != nodes.end(); ++itr)
+    if (ManeuverEngine::maneuverType != Dubins3d)
+        return _nodeIndex->findNearest(node);
+
+    // for Dubins maneuvers the closest node may be facing the wrong way; pick the
+    // euclidean candidate with the shortest possible maneuver instead. The candidates
+    // include the closest node, so it is never queried on its own
+    unsigned long closestNodeId = 0;
+    double bound, bestBound = INFINITY;
+    for (unsigned long id : _nodeIndex->findNearest(node, DUBINS_PARENT_CANDIDATE_COUNT, INFINITY))
     {
-        dist = itr->second.distanceTo(node);
-        if (dist < shortestDist)
+        bound = computeCostLowerBound(node, nodes.at(id));
+        if (!closestNodeId || bound < bestBound)
         {
-            shortestDist = dist;
-            closestNodeId = itr->first;
+            bestBound = bound;
+            closestNodeId = id;
         }
     }
-    return nodes[closestNodeId];
+
+    return closestNodeId;
+}
+
+ConfigspaceNode& ConfigspaceGraph::findClosestParentNode(GraphNode& node)
+{
+    return nodes[_findClosestParentId(node)];
 }
 
-double ConfigspaceGraph::computeCost(const State start, const State final) const
+double ConfigspaceGraph::computeCost(const State start, const State final, ManeuverEvaluationCache* cache) const
 {
+    if (cache)
+        return cache->evaluate(start, final).length();
     return ManeuverEngine::getPathLength(start, final);
 }
 
+double ConfigspaceGraph::computeCostLowerBound(const State start, const State final) const
+{
+    return ManeuverEngine::getPathLengthLowerBound(start, final);
+}
+
+double ConfigspaceGraph::neighborRadius(double epsilon) const
+{
+    return _computeRadius(epsilon);
+}
+
+vector<unsigned long> ConfigspaceGraph::_findNeighborIds(const GraphNode& centerNode, unsigned long excludedId, double radius, int k) const
+{
+    // query one extra node in case the excluded node is among the closest; Dubins
+    // maneuvers over-fetch so the candidates can be re-ranked by maneuver length bound
+    bool rankByManeuver = ManeuverEngine::maneuverType == Dubins3d;
+    int numCandidates = rankByManeuver ? DUBINS_NEIGHBOR_CANDIDATE_FACTOR * k + 1 : k + 1;
+
+    auto candidateIds = _nodeIndex->findNearest(centerNode, numCandidates, radius);
+
+    if (rankByManeuver)
+    {
+        vector<pair<double, unsigned long>> ranked;
+        ranked.reserve(candidateIds.size());
+        for (unsigned long id : candidateIds)
+            ranked.push_back({ computeCostLowerBound(centerNode, nodes.at(id)), id });
+
+        stable_sort(ranked.begin(), ranked.end());
+        for (size_t i = 0; i < ranked.size(); ++i)
+            candidateIds[i] = ranked[i].second;
+    }
+
+    vector<unsigned long> neighborIds;
+    neighborIds.reserve(min((int)candidateIds.size(), k));
+    for (unsigned long id : candidateIds)
+    {
+        if (excludedId == id)
+            continue;
+        neighborIds.push_back(id);
+        if (neighborIds.size() >= (size_t)k)
+            break;
+    }
+    return neighborIds;
+}
+
 vector<ConfigspaceNode> ConfigspaceGraph::findNeighbors(GraphNode& centerNode, double epsilon, int k)
 {
-    double dist, radius = _computeRadius(epsilon);
+    double radius = _computeRadius(epsilon);
+    _nodeIndex->setQueryRadius(radius);
+
     vector<ConfigspaceNode> neighbors(0);
+    for (unsigned long id : _findNeighborIds(centerNode, centerNode.parentId(), radius, k))
+        neighbors.push_back(nodes[id]);
+    return neighbors;
+}
 
-    for (auto itr = nodes.begin(); itr != nodes.end(); ++itr)
+vector<int> ConfigspaceGraph::_spatialOrder(const vector<ConfigspaceNode>& samples) const
+{
+    // quantize each axis to 10 bits within the freespace and interleave into a morton key
+    auto spread = [](unsigned long v) {
+        v = (v | (v << 16)) & 0x030000FF;
+        v = (v | (v << 8)) & 0x0300F00F;
+        v = (v | (v << 4)) & 0x030C30C3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    };
+    auto quantize = [](double value, double lo, double hi) {
+        double t = hi > lo ? (value - lo) / (hi - lo) : 0;
+        return (unsigned long)(min(max(t, 0.0), 1.0) * 1023);
+    };
+
+    vector<pair<unsigned long, int>> keys;
+    keys.reserve(samples.size());
+    for (int i = 0; i < (int)samples.size(); ++i)
     {
-        dist = itr->second.distanceTo(centerNode);
-        if (dist < radius && centerNode.parentId() != itr->second.id())
+        unsigned long key = spread(quantize(samples[i].x(), _minPoint.x(), _maxPoint.x())) |
+            (spread(quantize(samples[i].y(), _minPoint.y(), _maxPoint.y())) << 1) |
+            (spread(quantize(samples[i].z(), _minPoint.z(), _maxPoint.z())) << 2);
+        keys.push_back({ key, i });
+    }
+    sort(keys.begin(), keys.end());
+
+    vector<int> order;
+    order.reserve(keys.size());
+    for (auto& key : keys)
+        order.push_back(key.second);
+    return order;
+}
+
+void ConfigspaceGraph::_runBatch(int numSamples, int numThreads, const function<void(int, int)>& work) const
+{
+    if (numThreads <= 0)
+        numThreads = max(1, (int)thread::hardware_concurrency());
+    numThreads = max(1, min(numThreads, numSamples / BATCH_QUERY_MIN_SAMPLES_PER_THREAD));
+
+    // each worker gets a contiguous slice of the spatially ordered samples; the calling
+    // thread takes the first slice so a single thread never spawns anything
+    vector<thread> workers;
+    int sliceSize = (numSamples + numThreads - 1) / numThreads;
+    for (int t = 1; t < numThreads; ++t)
+    {
+        int begin = t * sliceSize, end = min(numSamples, begin + sliceSize);
+        if (begin < end)
+            workers.emplace_back(work, begin, end);
+    }
+    work(0, min(numSamples, sliceSize));
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+vector<unsigned long> ConfigspaceGraph::findClosestParentIds(const vector<ConfigspaceNode>& samples, int numThreads)
+{
+    vector<unsigned long> parentIds(samples.size(), 0);
+    auto order = _spatialOrder(samples);
+    bool rankByManeuver = ManeuverEngine::maneuverType == Dubins3d;
+
+    _runBatch(samples.size(), numThreads, [&](int begin, int end) {
+        if (rankByManeuver)
         {
-            neighbors.push_back(itr->second);
-            if (neighbors.size() >= k)
-                return neighbors;
+            for (int i = begin; i < end; ++i)
+                parentIds[order[i]] = _findClosestParentId(samples[order[i]]);
+            return;
         }
-    }
-    return neighbors;
+
+        // euclidean parents can be answered by the index as one batch
+        vector<Point> points;
+        points.reserve(end - begin);
+        for (int i = begin; i < end; ++i)
+            points.push_back(samples[order[i]]);
+
+        auto ids = _nodeIndex->findAllNearest(points);
+        for (int i = begin; i < end; ++i)
+            parentIds[order[i]] = ids[i - begin];
+    });
+
+    return parentIds;
 }
 
-ConfigspaceNode ConfigspaceGraph::findBestNeighbor(ConfigspaceNode& newNode, vector<ConfigspaceNode>& safeNeighbors)
+vector<vector<unsigned long>> ConfigspaceGraph::findNeighborIds(const vector<ConfigspaceNode>& centerNodes, double epsilon, int k, int numThreads)
+{
+    vector<vector<unsigned long>> neighborIds(centerNodes.size());
+    auto order = _spatialOrder(centerNodes);
+    double radius = _computeRadius(epsilon);
+
+    // the radius hint may reorganize the index, so it has to happen before the readers start
+    _nodeIndex->setQueryRadius(radius);
+
+    _runBatch(centerNodes.size(), numThreads, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+        {
+            auto& centerNode = centerNodes[order[i]];
+            neighborIds[order[i]] = _findNeighborIds(centerNode, centerNode.parentId(), radius, k);
+        }
+    });
+
+    return neighborIds;
+}
+
+vector<Neighborhood> ConfigspaceGraph::findNeighborhoods(const vector<ConfigspaceNode>& samples, double epsilon, int k, int numThreads)
+{
+    vector<Neighborhood> neighborhoods(samples.size());
+    auto parentIds = findClosestParentIds(samples, numThreads);
+    auto order = _spatialOrder(samples);
+    double radius = _computeRadius(epsilon);
+
+    _nodeIndex->setQueryRadius(radius);
+
+    _runBatch(samples.size(), numThreads, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+        {
+            int sample = order[i];
+            neighborhoods[sample].parentId = parentIds[sample];
+            neighborhoods[sample].neighborIds = _findNeighborIds(samples[sample], parentIds[sample], radius, k);
+        }
+    });
+
+    return neighborhoods;
+}
+
+ConfigspaceNode ConfigspaceGraph::findBestNeighbor(ConfigspaceNode& newNode, vector<ConfigspaceNode>& safeNeighbors, double costBound, ManeuverEvaluationCache* cache)
 {
     ConfigspaceNode bestNeighbor;
-    double tempBestCost = 0, bestCost = INFINITY;
+    double tempBestCost = 0, bestCost = costBound;
+
+    // visit neighbors by increasing cost lower bound so the exact (expensive) cost
+    // is only computed while a neighbor could still beat the best found so far
+    vector<pair<double, int>> bounds(safeNeighbors.size());
+    for (size_t i = 0; i < safeNeighbors.size(); ++i)
+        bounds[i] = { safeNeighbors[i].cost() + computeCostLowerBound(newNode, safeNeighbors[i]), i };
+    sort(bounds.begin(), bounds.end());
 
-    for (ConfigspaceNode n : safeNeighbors)
+    for (auto& bound : bounds)
     {
-        tempBestCost = n.cost() + computeCost(newNode, n);
+        if (bound.first >= bestCost)
+            break;
+
+        ConfigspaceNode& n = safeNeighbors[bound.second];
+        tempBestCost = n.cost() + computeCost(newNode, n, cache);
         if (tempBestCost < bestCost)
         {
             bestCost = tempBestCost;
@@ -180,7 +444,11 @@ ConfigspaceNode ConfigspaceGraph::findBestNeighbor(ConfigspaceNode& newNode, vec
 void ConfigspaceGraph::setRootNode(State state)
 {
     nodes.clear();
-    _parentChildMap.clear();
+    _firstChildIds.clear();
+    _nextSiblingIds.clear();
+    _prevSiblingIds.clear();
+    _goalNodes.clear();
+    _nodeIndex->clear();
     _numNodeInd = 0;
     addNode(ConfigspaceNode(state.x(), state.y(), state.z(), state.theta(), state.rho(), _numNodeInd, 0, 0));
 }
@@ -188,63 +456,77 @@ void ConfigspaceGraph::setRootNode(State state)
 int ConfigspaceGraph::addNode(ConfigspaceNode node)
 {
     node.setId(++_numNodeInd);
-    nodes[node.id()] = node;
-    nodes[node.id()].setPathTo(node.pathTo());
+    nodes.insert(node);
+    _nodeIndex->insert(node.id(), node);
     _addParentChildRelation(node.id());
+    _goalNodes.insert(node);
     return node.id();
 }
 
 void ConfigspaceGraph::propagateCost(unsigned long updatedNodeId)
 {
-    vector<unsigned long> updateNodes(1, updatedNodeId);
-    propagateCost(updateNodes);
+    _propagationStack.assign(1, updatedNodeId);
+    _propagateStackedCosts();
 }
 
 void ConfigspaceGraph::propagateCost(vector<unsigned long>& updatedNodeIds)
 {
-    if (updatedNodeIds.empty())
-        return;
-
-    auto children = _getAllChildIds(updatedNodeIds);
-    _recomputeCost(children);
-    propagateCost(children);
+    _propagationStack.assign(updatedNodeIds.begin(), updatedNodeIds.end());
+    _propagateStackedCosts();
 }
 
-vector<unsigned long> ConfigspaceGraph::_getAllChildIds(vector<unsigned long>& ids)
+void ConfigspaceGraph::_propagateStackedCosts()
 {
-    vector<unsigned long> childIds, tempChildIds;
-    for (int id : ids)
+    // depth first over the child lists; an edge keeps its maneuver, so its stored path length
+    // still holds and only the parent's cost has to be added again
+    while (!_propagationStack.empty())
     {
-        tempChildIds = _parentChildMap[id];
-        childIds.insert(childIds.begin(), tempChildIds.begin(), tempChildIds.end());
+        unsigned long id = _propagationStack.back();
+        _propagationStack.pop_back();
+        if (id >= _firstChildIds.size())
+            continue;
+
+        double cost = nodes[id].cost();
+        for (unsigned long childId = _firstChildIds[id]; childId; childId = _nextSiblingIds[childId])
+        {
+            ConfigspaceNode& child = nodes[childId];
+            child.setCost(cost + child.pathLength());
+            _goalNodes.updateCost(childId, child.cost());
+            _propagationStack.push_back(childId);
+        }
     }
-    return childIds;
 }
 
-void ConfigspaceGraph::_recomputeCost(vector<unsigned long>& ids)
+void ConfigspaceGraph::setNodeCost(unsigned long id, double cost)
 {
-    ConfigspaceNode node, parent;
-    for (int id : ids)
-    {
-        node = nodes[id];
-        parent= nodes[node.parentId()];
-        node.setCost(parent.cost() + computeCost(node, parent));
-    }
+    nodes[id].setCost(cost);
+    _goalNodes.updateCost(id, cost);
 }
 
+unsigned long ConfigspaceGraph::firstChildId(unsigned long id) const { return id < _firstChildIds.size() ? _firstChildIds[id] : 0; }
+
+unsigned long ConfigspaceGraph::nextSiblingId(unsigned long id) const { return id < _nextSiblingIds.size() ? _nextSiblingIds[id] : 0; }
+
 void ConfigspaceGraph::replaceNode(ConfigspaceNode oldNode, ConfigspaceNode newNode)
 {
     _removeParentChildRelation(oldNode.id());
     nodes.erase(oldNode.id());
 
-    nodes[newNode.id()] = newNode;
+    nodes.insert(newNode);
+    if (oldNode.id() != newNode.id())
+    {
+        _nodeIndex->remove(oldNode.id());
+        _goalNodes.erase(oldNode.id());
+    }
+    _nodeIndex->update(newNode.id(), newNode);
     _addParentChildRelation(newNode.id());
+    _goalNodes.insert(newNode);
 }
 
-ConfigspaceNode ConfigspaceGraph::extendToNode(ConfigspaceNode& parentNode, ConfigspaceNode& newNode, double maxDist) const
+ConfigspaceNode ConfigspaceGraph::extendToNode(ConfigspaceNode& parentNode, ConfigspaceNode& newNode, double maxDist, ManeuverEvaluationCache* cache) const
 {
     double dist = parentNode.distanceTo(newNode);
-    double x, y, z, cost;
+    double x, y, z, pathLength;
 
     if (dist >= maxDist)
     {
@@ -258,17 +540,18 @@ ConfigspaceNode ConfigspaceGraph::extendToNode(ConfigspaceNode& parentNode, Conf
         y = newNode.y();
         z = newNode.z();
     }
-    cost = nodes.at(parentNode.id()).cost() + computeCost(parentNode, State(x, y, z, newNode.theta(), newNode.rho()));
+    pathLength = computeCost(State(x, y, z, newNode.theta(), newNode.rho()), parentNode, cache);
 
-    ConfigspaceNode temp(x, y, z, newNode.theta(), newNode.rho(), 0, parentNode.id(), cost);
-    temp.generatePathFrom(parentNode);
+    ConfigspaceNode temp(x, y, z, newNode.theta(), newNode.rho(), 0, parentNode.id(), nodes.at(parentNode.id()).cost() + pathLength);
+    temp.setPathLength(pathLength);
 
     return temp;
 }
 
-ConfigspaceNode ConfigspaceGraph::connectNodes(ConfigspaceNode parentNode, ConfigspaceNode newNode)
+ConfigspaceNode ConfigspaceGraph::connectNodes(ConfigspaceNode parentNode, ConfigspaceNode newNode, ManeuverEvaluationCache* cache)
 {
     newNode.setParentId(parentNode.id());
-    newNode.setCost(parentNode.cost() + computeCost(parentNode, newNode));
+    newNode.setPathLength(computeCost(newNode, parentNode, cache));
+    newNode.setCost(parentNode.cost() + newNode.pathLength());
     return newNode;
 }
\ No newline at end of file
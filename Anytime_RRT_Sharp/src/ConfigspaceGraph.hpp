@@ -1,42 +1,87 @@
 #include <math.h>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <thread>
 #include <vector>
 #include <unordered_map>
 #include "cppshrhelp.hpp"
 #include "ConfigspaceNode.hpp"
+#include "GoalNodeSet.hpp"
 #include "ManeuverEngine.hpp"
+#include "NodeArena.hpp"
 #include "Geometry2D.hpp"
 #include "Geometry3D.hpp"
+#include "NodeIndex.hpp"
 
 using namespace std;
 
 #ifndef CONFIGSPACE_GRAPH_H
 #define CONFIGSPACE_GRAPH_H
 
+#define DUBINS_NEIGHBOR_CANDIDATE_FACTOR 2      // euclidean candidates fetched per requested neighbor before ranking by maneuver bound
+#define DUBINS_PARENT_CANDIDATE_COUNT 8         // euclidean candidates ranked by maneuver bound when choosing the closest parent
+#define BATCH_QUERY_MIN_SAMPLES_PER_THREAD 64   // smaller batches are not worth a worker thread
+
+class ManeuverEvaluationCache;
+
+// closest parent and neighbor set of a single sample in a batched query
+struct Neighborhood
+{
+    unsigned long parentId;
+    vector<unsigned long> neighborIds;
+};
+
 class ConfigspaceGraph : Rectangle
 {
     void buildGraph();
     void deleteGraph();
 
     static unsigned long _numNodeInd;                 // used to set the node id; is NOT modified by pruning
-    unordered_map<unsigned long, vector<unsigned long>> _parentChildMap;
 
-    vector<unsigned long> _getAllChildIds(vector<unsigned long>& ids);
+    // children of every node as a doubly linked list threaded through slots indexed by node id,
+    // like the arena; 0 ends a list. Nodes are passed around by value, so the links live here
+    vector<unsigned long> _firstChildIds, _nextSiblingIds, _prevSiblingIds;
+    vector<unsigned long> _propagationStack;          // reused by propagateCost
+    GoalNodeSet _goalNodes;                           // kept in sync with node costs like the index with positions
+    unique_ptr<NodeIndex> _nodeIndex;                 // spatial index over node positions; kept in sync with nodes
+    NodeIndexType _nodeIndexType;
+    double _neighborApproximationError;
+
     void _addParentChildRelation(unsigned long id);
     void _removeParentChildRelation(unsigned long id);
-    void _recomputeCost(vector<unsigned long>& ids);
+    void _propagateStackedCosts();
 
     // calculate the radius of the ball to consider for the k-nearest neighbor
     double _computeRadius(double epsilon) const;
 
+    // read-only query helpers shared by the single and batched queries
+    unsigned long _findClosestParentId(const GraphNode& node) const;
+    vector<unsigned long> _findNeighborIds(const GraphNode& centerNode, unsigned long excludedId, double radius, int k) const;
+
+    // indices of the samples sorted along a z-order curve so consecutive queries touch nearby nodes
+    vector<int> _spatialOrder(const vector<ConfigspaceNode>& samples) const;
+    void _runBatch(int numSamples, int numThreads, const function<void(int, int)>& work) const;
+
     public:
         double minTheta, maxTheta;
         double gamma_star;              // optimality constraint calculated from percollation theory
         int dim;                        // dimension of the free space
-        unordered_map<unsigned long, ConfigspaceNode> nodes;
+        NodeArena nodes;                // indexed by node id
         vector<Edge> edges;
 
         void setRootNode(State state);
+        void setNodeIndexType(NodeIndexType type);
+        NodeIndexType nodeIndexType() const;
+
+        // (1 + epsilon)-approximate parent and neighbor queries; only the k-d tree index honors it
+        void setNeighborApproximationError(double epsilon);
+        double neighborApproximationError() const;
+        ApproximateQueryStats approximateQueryStats() const;
+        // nodes closer than the tolerance to the goal are goal nodes; every cost change made
+        // through the graph keeps them ordered, so the cheapest is known without a search
+        void setGoalRegion(State goal, double tolerance);
+        const GoalNodeSet& goalNodes() const;
         int addNode(ConfigspaceNode node);
         vector<ConfigspaceNode>& removeNode(vector<ConfigspaceNode>& nodeVec, ConfigspaceNode& nodeToRemove);
 
@@ -54,19 +99,51 @@ class ConfigspaceGraph : Rectangle
         ConfigspaceNode generateRandomNode() const;
         ConfigspaceNode generateBiasedNode(State biasedState) const;
 
-        double computeCost(const State s1, const State s2) const;
+        // edge costs are the length of the maneuver from the child (s1) to its parent (s2), the
+        // direction paths are generated and checked in; a cache shares one maneuver per edge
+        double computeCost(const State s1, const State s2, ManeuverEvaluationCache* cache = nullptr) const;
+        double computeCostLowerBound(const State s1, const State s2) const;
 
-        // get the k-nearest neighbors from the current node
+        // radius of the ball searched by findNeighbors for the current number of nodes
+        double neighborRadius(double epsilon) const;
+
+        // get the k-nearest neighbors within the percolation radius, sorted by increasing distance
+        // (by maneuver length lower bound for Dubins3d maneuvers)
         // will not return the centerNode's parent node in the array
         vector<ConfigspaceNode> findNeighbors(GraphNode& centerNode, double radius, int maxNumNeighbors);
-        ConfigspaceNode findBestNeighbor(ConfigspaceNode& newNode, vector<ConfigspaceNode>& safeNeighbors);
+
+        // batched versions of findClosestParentNode and findNeighbors; the samples are answered in
+        // spatial order and split over numThreads worker threads (0 uses all hardware threads).
+        // results are identical to the single queries and are returned in sample order
+        vector<unsigned long> findClosestParentIds(const vector<ConfigspaceNode>& samples, int numThreads = 1);
+        vector<vector<unsigned long>> findNeighborIds(const vector<ConfigspaceNode>& centerNodes, double epsilon, int maxNumNeighbors, int numThreads = 1);
+
+        // closest parent of every sample together with its neighbors, excluding that parent
+        vector<Neighborhood> findNeighborhoods(const vector<ConfigspaceNode>& samples, double epsilon, int maxNumNeighbors, int numThreads = 1);
+
+        // returns the neighbor giving newNode the lowest cost, or a node with id 0 if none is cheaper than
+        // costBound; neighbors whose cost lower bound cannot beat the best so far are never evaluated
+        ConfigspaceNode findBestNeighbor(ConfigspaceNode& newNode, vector<ConfigspaceNode>& safeNeighbors, double costBound = INFINITY, ManeuverEvaluationCache* cache = nullptr);
+
+        // sets the cost of every descendant of the updated nodes to its parent's cost plus its
+        // path length, in place and without recursion
         void propagateCost(vector<unsigned long>& updatedNodeIds);
         void propagateCost(unsigned long updatedNodeId);
-        ConfigspaceNode extendToNode(ConfigspaceNode& parentNode, ConfigspaceNode& newNode, double maxDist) const;
-        ConfigspaceNode connectNodes(ConfigspaceNode parentNode, ConfigspaceNode newNode);
+
+        // changes the cost of a node without touching its descendants
+        void setNodeCost(unsigned long id, double cost);
+
+        // walks the children of a node: the first child, then each child's next sibling; 0 when
+        // there are no more
+        unsigned long firstChildId(unsigned long id) const;
+        unsigned long nextSiblingId(unsigned long id) const;
+        ConfigspaceNode extendToNode(ConfigspaceNode& parentNode, ConfigspaceNode& newNode, double maxDist, ManeuverEvaluationCache* cache = nullptr) const;
+        ConfigspaceNode connectNodes(ConfigspaceNode parentNode, ConfigspaceNode newNode, ManeuverEvaluationCache* cache = nullptr);
 
         // default constructor
         ConfigspaceGraph() { buildGraph(); }
+        ConfigspaceGraph(const ConfigspaceGraph& graph);
+        ConfigspaceGraph& operator=(const ConfigspaceGraph& graph);
 };
 
 #endif //CONFIGSPACE_GRAPH_H
\ No newline at end of file
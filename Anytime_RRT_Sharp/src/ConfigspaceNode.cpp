@@ -4,18 +4,21 @@ void ConfigspaceNode::_buildConfigspaceNode()
 {
     _buildGraphNode();
     _cost = 0;
+    _pathLength = 0;
 }
 
 void ConfigspaceNode::_buildConfigspaceNode(GraphNode n)
 {
     _buildGraphNode(n.x(), n.y(), n.z(), n.theta(), n.rho(), n.id(), n.parentId());
     _cost = 0;
+    _pathLength = 0;
 }
 
 void ConfigspaceNode::_buildConfigspaceNode(double x, double y, double z, double theta, double rho, unsigned long id, unsigned long parentId, double cost)
 {
     _buildGraphNode(x, y, z, theta, rho, id, parentId);
     _cost = cost;
+    _pathLength = 0;
 }
 
 ConfigspaceNode::ConfigspaceNode()
@@ -37,37 +40,11 @@ double ConfigspaceNode::cost() const { return _cost; }
 
 double ConfigspaceNode::pathLength() const { return _pathLength; }
 
-const vector<State>& ConfigspaceNode::pathTo() const { return _pathTo; }
-
 void ConfigspaceNode::setCost(double cost) { _cost = cost; }
 
-void ConfigspaceNode::setPathTo(const vector<State>& pathTo)
-{
-    int size = pathTo.size();
-
-    _pathTo.clear();
-    _pathTo.resize(size);
+void ConfigspaceNode::setPathLength(double pathLength) { _pathLength = pathLength; }
 
-    for (int i = 0; i < size; ++i)
-        _pathTo[i] = State(pathTo.at(i).x(), pathTo.at(i).y(), pathTo.at(i).z(), pathTo.at(i).theta(), pathTo.at(i).rho());
-}
-
-void ConfigspaceNode::setPathTo(const vector<State3d>& pathTo)
+vector<State> ConfigspaceNode::generatePathFrom(const GraphNode& parentState) const
 {
-    int size = pathTo.size();
-
-    _pathTo.resize(size);
-
-    for (int i = 0; i < size; ++i)
-        _pathTo[i] = State(pathTo.at(i).x, pathTo.at(i).y, pathTo.at(i).z, pathTo.at(i).theta, pathTo.at(i).gamma);
-}
-
-void ConfigspaceNode::generatePathFrom(GraphNode parentState)
-{
-    auto path = ManeuverEngine::generatePath(*this, parentState);
-    if (path.empty())
-        // no path possible
-        return;
-
-    setPathTo(path);
+    return ManeuverEngine::generatePath(*this, parentState);
 }
\ No newline at end of file
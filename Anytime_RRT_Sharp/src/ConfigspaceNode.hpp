@@ -8,10 +8,11 @@ using namespace std;
 #ifndef CONFIGSPACE_NODE_H
 #define CONFIGSPACE_NODE_H
 
+// a node only keeps the length of the maneuver from its parent; the maneuver itself is fully
+// determined by the two end states, so sampled paths are regenerated when they are needed
 class ConfigspaceNode : public GraphNode
 {
     double _cost, _pathLength;
-    vector<State> _pathTo;
     void _buildConfigspaceNode();
     void _buildConfigspaceNode(GraphNode node);
     void _buildConfigspaceNode(double x, double y, double z, double theta, double rho, unsigned long id, unsigned long parentId, double cost);
@@ -22,11 +23,12 @@ class ConfigspaceNode : public GraphNode
         ConfigspaceNode(double x, double y, double z, double theta, double rho, unsigned long id, unsigned long parentId, double cost);
         double cost() const;
         double pathLength() const;
-        const vector<State>& pathTo() const;
         void setCost(double cost);
-        void setPathTo(const vector<State>& pathTo);
-        void setPathTo(const vector<State3d>& pathTo);
-        void generatePathFrom(GraphNode parentState);
+        void setPathLength(double pathLength);
+
+        // samples the maneuver from this node to its parent, the direction edges run in, so the
+        // path starts at this node and ends at the parent; empty if no maneuver exists
+        vector<State> generatePathFrom(const GraphNode& parentState) const;
 };
 
 #endif //CONFIGSPACE_NODE_H
\ No newline at end of file
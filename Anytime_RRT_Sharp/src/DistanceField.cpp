@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <stdint.h>
+#include <thread>
+#include "DistanceField.hpp"
+
+DistanceField::DistanceField()
+{
+    _buildDistanceField();
+}
+
+void DistanceField::_buildDistanceField()
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        _origin[i] = 0;
+        _dims[i] = 0;
+    }
+    _resolution = 0;
+    _obstacleFingerprint = 0;
+    _distances.clear();
+}
+
+unsigned long DistanceField::_index(int i, int j, int k) const
+{
+    return ((unsigned long)k * _dims[1] + j) * _dims[0] + i;
+}
+
+void DistanceField::_buildSlices(const ObstacleBvh& obstacles, int begin, int end)
+{
+    for (int k = begin; k < end; ++k)
+        for (int j = 0; j < _dims[1]; ++j)
+            for (int i = 0; i < _dims[0]; ++i)
+            {
+                Point vertex(_origin[0] + i * _resolution, _origin[1] + j * _resolution, _origin[2] + k * _resolution);
+                double distance = obstacles.signedDistance(vertex);
+
+                // round toward -inf so the stored value stays a lower bound
+                float stored = (float)distance;
+                if (stored > distance)
+                    stored = nextafterf(stored, -INFINITY);
+                _distances[_index(i, j, k)] = stored;
+            }
+}
+
+void DistanceField::build(const Rectangle& limits, const ObstacleBvh& obstacles, double resolution, int numThreads)
+{
+    _buildDistanceField();
+    if (resolution <= 0)
+        throw invalid_argument("DistanceField::build: resolution must be positive");
+
+    _resolution = resolution;
+    _obstacleFingerprint = fingerprint(obstacles.obstacles());
+    double minCoords[3] = { limits.minX(), limits.minY(), limits.minZ() };
+    double maxCoords[3] = { limits.maxX(), limits.maxY(), limits.maxZ() };
+    for (int i = 0; i < 3; ++i)
+    {
+        _origin[i] = minCoords[i];
+        _dims[i] = (int)ceil((maxCoords[i] - minCoords[i]) / resolution) + 1;
+    }
+    _distances.resize((unsigned long)_dims[0] * _dims[1] * _dims[2]);
+
+    if (numThreads <= 0)
+        numThreads = max(1, (int)thread::hardware_concurrency());
+    numThreads = max(1, min(numThreads, _dims[2] / DISTANCE_FIELD_MIN_SLICES_PER_THREAD));
+
+    // every vertex is independent and each worker writes its own slices
+    vector<thread> workers;
+    int slicesPerThread = (_dims[2] + numThreads - 1) / numThreads;
+    for (int t = 1; t < numThreads; ++t)
+    {
+        int begin = t * slicesPerThread, end = min(_dims[2], begin + slicesPerThread);
+        if (begin < end)
+            workers.emplace_back(&DistanceField::_buildSlices, this, cref(obstacles), begin, end);
+    }
+    _buildSlices(obstacles, 0, min(_dims[2], slicesPerThread));
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void DistanceField::clear()
+{
+    _buildDistanceField();
+}
+
+bool DistanceField::empty() const { return _distances.empty(); }
+
+double DistanceField::resolution() const { return _resolution; }
+
+Point DistanceField::minPoint() const { return Point(_origin[0], _origin[1], _origin[2]); }
+
+Point DistanceField::maxPoint() const
+{
+    return Point(_origin[0] + (_dims[0] - 1) * _resolution, _origin[1] + (_dims[1] - 1) * _resolution, _origin[2] + (_dims[2] - 1) * _resolution);
+}
+
+unsigned long DistanceField::size() const { return _distances.size(); }
+
+unsigned long DistanceField::bytes() const { return _distances.size() * sizeof(float); }
+
+uint64_t DistanceField::fingerprint(const vector<Shape3d*>& obstacles)
+{
+    // FNV-1a over each obstacle's parameters, mixed and summed so the order doesn't matter
+    uint64_t sum = obstacles.size();
+    for (auto o : obstacles)
+    {
+        vector<double> params;
+        if (auto sphere = dynamic_cast<const Sphere*>(o))
+            params = { 1, sphere->x(), sphere->y(), sphere->z(), sphere->radius() };
+        else if (auto rect = dynamic_cast<const Rectangle*>(o))
+            params = { 2, rect->minX(), rect->minY(), rect->minZ(), rect->maxX(), rect->maxY(), rect->maxZ() };
+        else
+        {
+            Point minBound = o->minBound(), maxBound = o->maxBound();
+            params = { 0, minBound.x(), minBound.y(), minBound.z(), maxBound.x(), maxBound.y(), maxBound.z() };
+        }
+
+        uint64_t hash = 14695981039346656037ull;
+        auto bytes = (const unsigned char*)params.data();
+        for (unsigned long i = 0; i < params.size() * sizeof(double); ++i)
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        sum += hash;
+    }
+    return sum;
+}
+
+uint64_t DistanceField::obstacleFingerprint() const { return _obstacleFingerprint; }
+
+bool DistanceField::covers(const Rectangle& limits, double resolution, uint64_t obstacleFingerprint) const
+{
+    double minCoords[3] = { limits.minX(), limits.minY(), limits.minZ() };
+    double maxCoords[3] = { limits.maxX(), limits.maxY(), limits.maxZ() };
+    if (_distances.empty() || _resolution != resolution || _obstacleFingerprint != obstacleFingerprint)
+        return false;
+
+    for (int i = 0; i < 3; ++i)
+        if (_origin[i] != minCoords[i] || _dims[i] != (int)ceil((maxCoords[i] - minCoords[i]) / resolution) + 1)
+            return false;
+    return true;
+}
+
+bool DistanceField::lookup(const Point& p, double& lower, double& upper) const
+{
+    if (_distances.empty())
+        return false;
+
+    double coords[3] = { p.x(), p.y(), p.z() };
+    int cell[3];
+    double offsetSq = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        double u = (coords[i] - _origin[i]) / _resolution;
+        if (!(u >= 0 && u <= _dims[i] - 1))
+            return false;
+
+        cell[i] = (int)lround(u);
+        double offset = coords[i] - (_origin[i] + cell[i] * _resolution);
+        offsetSq += offset * offset;
+    }
+
+    float stored = _distances[_index(cell[0], cell[1], cell[2])];
+    double offset = sqrt(offsetSq);
+    lower = stored - offset;
+    upper = nextafterf(stored, INFINITY) + offset;
+    return true;
+}
+
+void DistanceField::save(const string& fileName) const
+{
+    ofstream file(fileName, ios::binary);
+    if (!file)
+        throw runtime_error("DistanceField::save: cannot open " + fileName);
+
+    uint32_t header[2] = { DISTANCE_FIELD_FILE_MAGIC, DISTANCE_FIELD_FILE_VERSION };
+    int32_t dims[3] = { _dims[0], _dims[1], _dims[2] };
+    file.write((const char*)header, sizeof(header));
+    file.write((const char*)&_obstacleFingerprint, sizeof(_obstacleFingerprint));
+    file.write((const char*)_origin, sizeof(_origin));
+    file.write((const char*)&_resolution, sizeof(_resolution));
+    file.write((const char*)dims, sizeof(dims));
+    file.write((const char*)_distances.data(), _distances.size() * sizeof(float));
+
+    if (!file)
+        throw runtime_error("DistanceField::save: failed writing " + fileName);
+}
+
+void DistanceField::load(const string& fileName)
+{
+    ifstream file(fileName, ios::binary);
+    if (!file)
+        throw runtime_error("DistanceField::load: cannot open " + fileName);
+
+    uint32_t header[2];
+    int32_t dims[3];
+    uint64_t obstacleFingerprint;
+    double origin[3], resolution;
+    file.read((char*)header, sizeof(header));
+    file.read((char*)&obstacleFingerprint, sizeof(obstacleFingerprint));
+    file.read((char*)origin, sizeof(origin));
+    file.read((char*)&resolution, sizeof(resolution));
+    file.read((char*)dims, sizeof(dims));
+
+    if (!file || header[0] != DISTANCE_FIELD_FILE_MAGIC || header[1] != DISTANCE_FIELD_FILE_VERSION)
+        throw runtime_error("DistanceField::load: " + fileName + " is not a distance field");
+    if (resolution <= 0 || dims[0] <= 0 || dims[1] <= 0 || dims[2] <= 0)
+        throw runtime_error("DistanceField::load: " + fileName + " has an invalid grid");
+
+    vector<float> distances((unsigned long)dims[0] * dims[1] * dims[2]);
+    file.read((char*)distances.data(), distances.size() * sizeof(float));
+    if (!file)
+        throw runtime_error("DistanceField::load: " + fileName + " is truncated");
+
+    for (int i = 0; i < 3; ++i)
+    {
+        _origin[i] = origin[i];
+        _dims[i] = dims[i];
+    }
+    _resolution = resolution;
+    _obstacleFingerprint = obstacleFingerprint;
+    _distances = move(distances);
+}
\ No newline at end of file
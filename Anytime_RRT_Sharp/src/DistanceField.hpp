@@ -0,0 +1,64 @@
+#include <math.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Geometry2D.hpp"
+#include "Geometry3D.hpp"
+#include "ObstacleBvh.hpp"
+
+using namespace std;
+
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#define DISTANCE_FIELD_FILE_MAGIC 0x46445341     // "ASDF"
+#define DISTANCE_FIELD_FILE_VERSION 2
+#define DISTANCE_FIELD_MIN_SLICES_PER_THREAD 4
+
+// signed distance to the nearest obstacle sampled on a regular grid of vertices over the
+// workspace limits; distances are stored as floats rounded down so every stored value is a
+// lower bound, and since the distance changes no faster than the position, a lookup at any
+// point is bounded by the nearest vertex's value plus or minus the distance to that vertex
+class DistanceField
+{
+    double _origin[3], _resolution;
+    int _dims[3];
+    uint64_t _obstacleFingerprint;
+    vector<float> _distances;
+
+    void _buildDistanceField();
+    unsigned long _index(int i, int j, int k) const;
+    void _buildSlices(const ObstacleBvh& obstacles, int begin, int end);
+
+    public:
+        DistanceField();
+
+        // samples the limits every resolution units in parallel over z slices; 0 threads uses
+        // every hardware thread
+        void build(const Rectangle& limits, const ObstacleBvh& obstacles, double resolution, int numThreads = 0);
+        void clear();
+        bool empty() const;
+        double resolution() const;
+        Point minPoint() const;
+        Point maxPoint() const;
+        unsigned long size() const;
+        unsigned long bytes() const;
+
+        // hash of every obstacle's type and parameters, independent of their order; the vehicle
+        // margin is subtracted at lookup, so a field doesn't depend on the vehicle
+        static uint64_t fingerprint(const vector<Shape3d*>& obstacles);
+        uint64_t obstacleFingerprint() const;
+
+        // true if the grid is the one build would sample over the limits at the resolution from
+        // obstacles with the fingerprint
+        bool covers(const Rectangle& limits, double resolution, uint64_t obstacleFingerprint) const;
+
+        // bounds on the signed distance at the point; false outside the grid
+        bool lookup(const Point& p, double& lower, double& upper) const;
+
+        // binary snapshot of the grid; throws runtime_error if the file can't be written or read
+        void save(const string& fileName) const;
+        void load(const string& fileName);
+};
+
+#endif //DISTANCE_FIELD_H
\ No newline at end of file
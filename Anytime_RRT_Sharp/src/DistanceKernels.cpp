@@ -0,0 +1,255 @@
+#include <math.h>
+#include "DistanceKernels.hpp"
+
+#ifdef DISTANCE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+// avx512f implies fma, so stop the compiler from fusing multiplies and adds; every
+// kernel must round the same way to produce bit-identical distances
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+static void squaredDistancesScalar(const double* xs, const double* ys, const double* zs, unsigned long n, const double* point, double* out)
+{
+    for (unsigned long i = 0; i < n; ++i)
+    {
+        double dx = xs[i] - point[0];
+        double dy = ys[i] - point[1];
+        double dz = zs[i] - point[2];
+        out[i] = dx * dx + dy * dy + dz * dz;
+    }
+}
+
+static unsigned long nearestIndexScalar(const double* xs, const double* ys, const double* zs, unsigned long n, const double* point, double& bestDistSq)
+{
+    unsigned long bestIndex = n;
+    bestDistSq = INFINITY;
+    for (unsigned long i = 0; i < n; ++i)
+    {
+        double dx = xs[i] - point[0];
+        double dy = ys[i] - point[1];
+        double dz = zs[i] - point[2];
+        double distSq = dx * dx + dy * dy + dz * dz;
+        if (distSq < bestDistSq)
+        {
+            bestDistSq = distSq;
+            bestIndex = i;
+        }
+    }
+    return bestIndex;
+}
+
+#ifdef DISTANCE_KERNELS_X86
+
+// the vector kernels use separate multiplies and adds in the same order as the scalar kernel
+
+__attribute__((target("avx2")))
+static void squaredDistancesAvx2(const double* xs, const double* ys, const double* zs, unsigned long n, const double* point, double* out)
+{
+    __m256d px = _mm256_set1_pd(point[0]);
+    __m256d py = _mm256_set1_pd(point[1]);
+    __m256d pz = _mm256_set1_pd(point[2]);
+
+    unsigned long i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + i), px);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + i), py);
+        __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(zs + i), pz);
+        __m256d distSq = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+        _mm256_storeu_pd(out + i, distSq);
+    }
+    squaredDistancesScalar(xs + i, ys + i, zs + i, n - i, point, out + i);
+}
+
+__attribute__((target("avx2")))
+static unsigned long nearestIndexAvx2(const double* xs, const double* ys, const double* zs, unsigned long n, const double* point, double& bestDistSq)
+{
+    __m256d px = _mm256_set1_pd(point[0]);
+    __m256d py = _mm256_set1_pd(point[1]);
+    __m256d pz = _mm256_set1_pd(point[2]);
+    __m256d step = _mm256_set1_pd(8);
+
+    // two independent accumulators hide the latency of the compare/blend chain
+    __m256d best[2] = { _mm256_set1_pd(INFINITY), _mm256_set1_pd(INFINITY) };
+    __m256d bestIdx[2] = { _mm256_set1_pd(-1), _mm256_set1_pd(-1) };
+    __m256d idx[2] = { _mm256_set_pd(3, 2, 1, 0), _mm256_set_pd(7, 6, 5, 4) };
+
+    unsigned long i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        for (int a = 0; a < 2; ++a)
+        {
+            __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + i + 4 * a), px);
+            __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + i + 4 * a), py);
+            __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(zs + i + 4 * a), pz);
+            __m256d distSq = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+
+            __m256d closer = _mm256_cmp_pd(distSq, best[a], _CMP_LT_OQ);
+            best[a] = _mm256_blendv_pd(best[a], distSq, closer);
+            bestIdx[a] = _mm256_blendv_pd(bestIdx[a], idx[a], closer);
+            idx[a] = _mm256_add_pd(idx[a], step);
+        }
+    }
+
+    double lanes[8], laneIdx[8];
+    _mm256_storeu_pd(lanes, best[0]);
+    _mm256_storeu_pd(lanes + 4, best[1]);
+    _mm256_storeu_pd(laneIdx, bestIdx[0]);
+    _mm256_storeu_pd(laneIdx + 4, bestIdx[1]);
+
+    unsigned long bestIndex = n;
+    bestDistSq = INFINITY;
+    for (int lane = 0; lane < 8; ++lane)
+    {
+        if (laneIdx[lane] < 0)
+            continue;
+        unsigned long laneIndex = (unsigned long)laneIdx[lane];
+        if (lanes[lane] < bestDistSq || (lanes[lane] == bestDistSq && laneIndex < bestIndex))
+        {
+            bestDistSq = lanes[lane];
+            bestIndex = laneIndex;
+        }
+    }
+
+    double tailDistSq;
+    unsigned long tailIndex = nearestIndexScalar(xs + i, ys + i, zs + i, n - i, point, tailDistSq);
+    if (tailIndex < n - i && tailDistSq < bestDistSq)
+    {
+        bestDistSq = tailDistSq;
+        bestIndex = i + tailIndex;
+    }
+    return bestIndex;
+}
+
+__attribute__((target("avx512f")))
+static void squaredDistancesAvx512(const double* xs, const double* ys, const double* zs, unsigned long n, const double* point, double* out)
+{
+    __m512d px = _mm512_set1_pd(point[0]);
+    __m512d py = _mm512_set1_pd(point[1]);
+    __m512d pz = _mm512_set1_pd(point[2]);
+
+    unsigned long i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(xs + i), px);
+        __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(ys + i), py);
+        __m512d dz = _mm512_sub_pd(_mm512_loadu_pd(zs + i), pz);
+        __m512d distSq = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy)), _mm512_mul_pd(dz, dz));
+        _mm512_storeu_pd(out + i, distSq);
+    }
+    squaredDistancesScalar(xs + i, ys + i, zs + i, n - i, point, out + i);
+}
+
+__attribute__((target("avx512f")))
+static unsigned long nearestIndexAvx512(const double* xs, const double* ys, const double* zs, unsigned long n, const double* point, double& bestDistSq)
+{
+    __m512d px = _mm512_set1_pd(point[0]);
+    __m512d py = _mm512_set1_pd(point[1]);
+    __m512d pz = _mm512_set1_pd(point[2]);
+    __m512d best = _mm512_set1_pd(INFINITY);
+    __m512d bestIdx = _mm512_set1_pd(-1);
+    __m512d idx = _mm512_set_pd(7, 6, 5, 4, 3, 2, 1, 0);
+    __m512d step = _mm512_set1_pd(8);
+
+    unsigned long i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(xs + i), px);
+        __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(ys + i), py);
+        __m512d dz = _mm512_sub_pd(_mm512_loadu_pd(zs + i), pz);
+        __m512d distSq = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy)), _mm512_mul_pd(dz, dz));
+
+        __mmask8 closer = _mm512_cmp_pd_mask(distSq, best, _CMP_LT_OQ);
+        best = _mm512_mask_blend_pd(closer, best, distSq);
+        bestIdx = _mm512_mask_blend_pd(closer, bestIdx, idx);
+        idx = _mm512_add_pd(idx, step);
+    }
+
+    double lanes[8] = {}, laneIdx[8] = {};
+    _mm512_storeu_pd(lanes, best);
+    _mm512_storeu_pd(laneIdx, bestIdx);
+
+    unsigned long bestIndex = n;
+    bestDistSq = INFINITY;
+    for (int lane = 0; lane < 8; ++lane)
+    {
+        if (laneIdx[lane] < 0)
+            continue;
+        unsigned long laneIndex = (unsigned long)laneIdx[lane];
+        if (lanes[lane] < bestDistSq || (lanes[lane] == bestDistSq && laneIndex < bestIndex))
+        {
+            bestDistSq = lanes[lane];
+            bestIndex = laneIndex;
+        }
+    }
+
+    double tailDistSq;
+    unsigned long tailIndex = nearestIndexScalar(xs + i, ys + i, zs + i, n - i, point, tailDistSq);
+    if (tailIndex < n - i && tailDistSq < bestDistSq)
+    {
+        bestDistSq = tailDistSq;
+        bestIndex = i + tailIndex;
+    }
+    return bestIndex;
+}
+
+#endif //DISTANCE_KERNELS_X86
+
+DistanceKernels::KernelTable DistanceKernels::_kernelsFor(DistanceKernelType type)
+{
+#ifdef DISTANCE_KERNELS_X86
+    if (type == Avx512Kernel)
+        return { Avx512Kernel, squaredDistancesAvx512, nearestIndexAvx512 };
+    if (type == Avx2Kernel)
+        return { Avx2Kernel, squaredDistancesAvx2, nearestIndexAvx2 };
+#endif
+    return { ScalarKernel, squaredDistancesScalar, nearestIndexScalar };
+}
+
+DistanceKernels::KernelTable& DistanceKernels::_kernels()
+{
+    static KernelTable kernels = _kernelsFor(bestSupportedKernelType());
+    return kernels;
+}
+
+bool DistanceKernels::isSupported(DistanceKernelType type)
+{
+#ifdef DISTANCE_KERNELS_X86
+    if (type == Avx512Kernel)
+        return __builtin_cpu_supports("avx512f");
+    if (type == Avx2Kernel)
+        return __builtin_cpu_supports("avx2");
+#endif
+    return type == ScalarKernel;
+}
+
+DistanceKernelType DistanceKernels::bestSupportedKernelType()
+{
+    if (isSupported(Avx512Kernel))
+        return Avx512Kernel;
+    if (isSupported(Avx2Kernel))
+        return Avx2Kernel;
+    return ScalarKernel;
+}
+
+DistanceKernelType DistanceKernels::kernelType() { return _kernels().type; }
+
+void DistanceKernels::setKernelType(DistanceKernelType type)
+{
+    _kernels() = _kernelsFor(isSupported(type) ? type : ScalarKernel);
+}
+
+void DistanceKernels::squaredDistances(const double* xs, const double* ys, const double* zs, unsigned long n, const double* point, double* out)
+{
+    _kernels().squaredDistances(xs, ys, zs, n, point, out);
+}
+
+unsigned long DistanceKernels::nearestIndex(const double* xs, const double* ys, const double* zs, unsigned long n, const double* point, double& bestDistSq)
+{
+    return _kernels().nearestIndex(xs, ys, zs, n, point, bestDistSq);
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include <vector>
+
+using namespace std;
+
+#ifndef DISTANCE_KERNELS_H
+#define DISTANCE_KERNELS_H
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define DISTANCE_KERNELS_X86
+#endif
+
+enum DistanceKernelType
+{
+    ScalarKernel,
+    Avx2Kernel,
+    Avx512Kernel
+};
+
+// brute-force squared euclidean distance kernels over structure-of-arrays coordinates;
+// the widest kernel supported by the running CPU is selected on first use
+class DistanceKernels
+{
+    typedef void (*squared_distances_t)(const double* xs, const double* ys, const double* zs, unsigned long n, const double* point, double* out);
+    typedef unsigned long (*nearest_index_t)(const double* xs, const double* ys, const double* zs, unsigned long n, const double* point, double& bestDistSq);
+
+    struct KernelTable
+    {
+        DistanceKernelType type;
+        squared_distances_t squaredDistances;
+        nearest_index_t nearestIndex;
+    };
+
+    static KernelTable& _kernels();
+    static KernelTable _kernelsFor(DistanceKernelType type);
+
+    public:
+        static DistanceKernelType kernelType();
+        static DistanceKernelType bestSupportedKernelType();
+        static bool isSupported(DistanceKernelType type);
+
+        // overrides the dispatched kernel (e.g. for benchmarks); not thread safe with running queries
+        static void setKernelType(DistanceKernelType type);
+
+        // writes the squared distance from point to each of the n coordinates into out
+        static void squaredDistances(const double* xs, const double* ys, const double* zs, unsigned long n, const double* point, double* out);
+
+        // returns the index of the closest coordinate (the lowest index on ties) and its squared
+        // distance; returns n and leaves bestDistSq at infinity when n is zero
+        static unsigned long nearestIndex(const double* xs, const double* ys, const double* zs, unsigned long n, const double* point, double& bestDistSq);
+};
+
+#endif //DISTANCE_KERNELS_H
\ No newline at end of file
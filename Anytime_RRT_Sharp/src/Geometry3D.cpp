@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "Geometry3D.hpp"
 
 Sphere::Sphere()
@@ -56,44 +57,29 @@ bool Sphere::intersects(const Point& point) const
 
 bool Sphere::intersects(const Line& line) const
 {
-    // http://paulbourke.net/geometry/circlesphere/index.html#linesphere
-    Point p1 = line.p1();
-    Vector u = line.tangent();
-
-    double a = u.x()*u.x() + u.y()*u.y() + u.z()*u.z();
-    double b = 2 * (u.x() * (p1.x() - x()) + u.y() * (p1.y() - y()) + u.z() * (p1.z() - z()));
-    double c = x()*x() + y()*y() + z()*z();
-
-    c += p1.x()*p1.x() + p1.y()*p1.y() + p1.z()*p1.z();
-    c -= 2 * (x()*p1.x() + y()*p1.y() + z()*p1.z());
-    c -= radius()*radius();
-
-    double det = b*b - 4*a*c;
-
-    // no intersection
-    if (det < 0)
-        return false;
-
-    // get intersection points
-    double mu1 = (-b + sqrt(det)) / (2 * a);
-    double mu2 = (-b - sqrt(det)) / (2 * a);
-
-    Point pi1 = line.p1() + u * mu1;
-    Point pi2 = line.p1() + u * mu2;
-
-    // detmine if either point lies on line segment
-    // https://lucidar.me/en/mathematics/check-if-a-point-belongs-on-a-line-segment/
-    Vector kac1 = pi1 - line.p1();
-    Vector kac2 = pi2 - line.p1();
+    return intersectsCapsule(line, 0);
+}
 
-    double dotU = u.dot(u);
-    double dotKac1 = kac1.dot(u);
-    double dotKac2 = kac2.dot(u);
+bool Sphere::intersectsCapsule(const Line& axis, double radius) const
+{
+    // the capsule hits the sphere iff the closest point on its axis to the center is within
+    // both radii of it
+    Point p1 = axis.p1(), p2 = axis.p2();
+    double dx = p2.x() - p1.x(), dy = p2.y() - p1.y(), dz = p2.z() - p1.z();
+    double cx = x() - p1.x(), cy = y() - p1.y(), cz = z() - p1.z();
+    double lengthSq = dx*dx + dy*dy + dz*dz;
+
+    double t = lengthSq > 0 ? (cx*dx + cy*dy + cz*dz) / lengthSq : 0;
+    t = min(max(t, 0.0), 1.0);
+
+    double ex = cx - t*dx, ey = cy - t*dy, ez = cz - t*dz;
+    double reach = _radius + radius;
+    return ex*ex + ey*ey + ez*ez <= reach*reach;
+}
 
-    if ((dotKac1 >= 0 && dotKac1 <= dotU) || (dotKac2 >= 0 && dotKac2 <= dotU))
-        return true;
-    
-    return false;
+double Sphere::signedDistance(const Point& p) const
+{
+    return distanceTo(p) - _radius;
 }
 
 bool Sphere::intersects(const Shape3d& shape) const
@@ -108,6 +94,12 @@ double Sphere::radius() const { return _radius; }
 
 double Sphere::volume() const { return _area; }
 
+double Sphere::minWidth() const { return 2.0 * _radius; }
+
+Point Sphere::minBound() const { return Point(_x - _radius, _y - _radius, _z - _radius); }
+
+Point Sphere::maxBound() const { return Point(_x + _radius, _y + _radius, _z + _radius); }
+
 Rectangle::Rectangle()
 {
     _minPoint = Point();
@@ -185,28 +177,52 @@ bool Rectangle::intersects(const Point& point) const
 
 bool Rectangle::intersects(const Line& line) const
 {
-    // https://stackoverflow.com/questions/66523293/intersection-of-line-with-rectangular-prism-python
-    Point p;
-    double epsilon = 0.001;
-    bool inXLimits, inYLimits, inZLimits, inLineLimits;
+    return intersectsCapsule(line, 0);
+}
 
-    for (Plane plane : surfaces())
+bool Rectangle::intersectsCapsule(const Line& axis, double radius) const
+{
+    // slab test of the axis against the rectangle grown by the radius on every side, which
+    // contains the true rounded sum and so only adds false positives near the corners;
+    // the segment parameter range [0, 1] is clipped against each axis-aligned slab
+    Point p1 = axis.p1(), p2 = axis.p2();
+    double origin[3] = { p1.x(), p1.y(), p1.z() };
+    double delta[3] = { p2.x() - p1.x(), p2.y() - p1.y(), p2.z() - p1.z() };
+    double lower[3] = { minX() - radius, minY() - radius, minZ() - radius };
+    double upper[3] = { maxX() + radius, maxY() + radius, maxZ() + radius };
+    double tMin = 0, tMax = 1;
+
+    for (int i = 0; i < 3; ++i)
     {
-        p = plane.getIntersectionPoint(line);
-
-        if (&p == NULL)
-            break;
-
-        inXLimits = p.x() + epsilon >= minX() && p.x() - epsilon <= maxX();
-        inYLimits = p.y() + epsilon >= minY() && p.y() - epsilon <= maxY();
-        inZLimits = p.z() + epsilon >= minZ() && p.z() - epsilon <= maxZ();
-        inLineLimits = line.p1().distanceTo(p) <= line.length() && line.p2().distanceTo(p) <= line.length();
-
-        if (inXLimits && inYLimits && inZLimits && inLineLimits)
-            return true;
+        // parallel to the slab: inside it for the whole segment or never
+        if (delta[i] == 0)
+        {
+            if (origin[i] < lower[i] || origin[i] > upper[i])
+                return false;
+            continue;
+        }
+
+        double t1 = (lower[i] - origin[i]) / delta[i];
+        double t2 = (upper[i] - origin[i]) / delta[i];
+        tMin = max(tMin, min(t1, t2));
+        tMax = min(tMax, max(t1, t2));
+        if (tMin > tMax)
+            return false;
     }
 
-    return false;
+    return true;
+}
+
+double Rectangle::signedDistance(const Point& p) const
+{
+    // per-axis distance outside the faces; positive components give the distance to the
+    // nearest face, edge or corner and the largest component the depth inside
+    double dx = max(minX() - p.x(), p.x() - maxX());
+    double dy = max(minY() - p.y(), p.y() - maxY());
+    double dz = max(minZ() - p.z(), p.z() - maxZ());
+
+    double ox = max(dx, 0.0), oy = max(dy, 0.0), oz = max(dz, 0.0);
+    return sqrt(ox*ox + oy*oy + oz*oz) + min(max({ dx, dy, dz }), 0.0);
 }
 
 bool Rectangle::intersects(const Shape3d& shape) const
@@ -231,6 +247,12 @@ Point Rectangle::maxPoint() const { return _maxPoint; }
 
 double Rectangle::volume() const { return _volume; }
 
+double Rectangle::minWidth() const { return min({ maxX() - minX(), maxY() - minY(), maxZ() - minZ() }); }
+
+Point Rectangle::minBound() const { return _minPoint; }
+
+Point Rectangle::maxBound() const { return _maxPoint; }
+
 double Rectangle::minX() const { return _minPoint.x(); }
 
 double Rectangle::minY() const { return _minPoint.y(); }
@@ -10,10 +10,24 @@ using namespace std;
 
 struct Shape3d
 {
+    virtual ~Shape3d() {}
+
     virtual double volume() const { return 0; };
+    virtual double minWidth() const { return 0; };     // thinnest extent; bounds how far apart path samples may be
+
+    // axis-aligned bounds; unbounded unless a shape knows better, which keeps it in every query
+    virtual Point minBound() const { return Point(-INFINITY, -INFINITY, -INFINITY); };
+    virtual Point maxBound() const { return Point(INFINITY, INFINITY, INFINITY); };
     virtual bool intersects(const Point& p) const { return true; };
     virtual bool intersects(const Line& l) const { return true; };
     virtual bool intersects(const Shape3d& s) const { return true; };
+
+    // capsule of the given radius around a segment; may report false positives but never misses
+    virtual bool intersectsCapsule(const Line& /*axis*/, double /*radius*/) const { return true; };
+
+    // distance from the point to the surface, negative inside; never positive where intersects
+    // is true, so shapes that don't know better are inside everywhere
+    virtual double signedDistance(const Point& /*p*/) const { return -INFINITY; };
 };
 
 class DLL_EXPORT Rectangle: public Shape3d
@@ -35,6 +49,8 @@ class DLL_EXPORT Rectangle: public Shape3d
         bool intersects(const Point& p) const;
         bool intersects(const Line& l) const;
         bool intersects(const Shape3d& s) const;
+        bool intersectsCapsule(const Line& axis, double radius) const;
+        double signedDistance(const Point& p) const;
         const vector<Plane>& surfaces() const;
         const Plane& surfaces(int i) const;
         const vector<Point>& points() const;
@@ -42,6 +58,9 @@ class DLL_EXPORT Rectangle: public Shape3d
         Point minPoint() const;
         Point maxPoint() const;
         double volume() const;
+        double minWidth() const;
+        Point minBound() const;
+        Point maxBound() const;
         double minX() const;
         double minY() const;
         double minZ() const;
@@ -65,8 +84,13 @@ class DLL_EXPORT Sphere : public Point, public Shape3d
         bool intersects(const Point& p) const;
         bool intersects(const Line& l) const;
         bool intersects(const Shape3d& s) const;
+        bool intersectsCapsule(const Line& axis, double radius) const;
+        double signedDistance(const Point& p) const;
         double radius() const;
         double volume() const;
+        double minWidth() const;
+        Point minBound() const;
+        Point maxBound() const;
 };
 
 #endif //GEOMETRY_3D_H
\ No newline at end of file
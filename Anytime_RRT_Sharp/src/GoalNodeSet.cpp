@@ -0,0 +1,69 @@
+#include "GoalNodeSet.hpp"
+
+GoalNodeSet::GoalNodeSet()
+{
+    _buildGoalNodeSet();
+}
+
+void GoalNodeSet::_buildGoalNodeSet()
+{
+    _goal = State();
+    _tolerance = -INFINITY;
+    clear();
+}
+
+void GoalNodeSet::setGoal(State goal, double tolerance)
+{
+    _goal = goal;
+    _tolerance = tolerance;
+    clear();
+}
+
+bool GoalNodeSet::isInRegion(const State& state) const { return state.distanceTo(_goal) < _tolerance; }
+
+bool GoalNodeSet::contains(unsigned long id) const { return id < _costs.size() && !isnan(_costs[id]); }
+
+void GoalNodeSet::insert(const ConfigspaceNode& node)
+{
+    if (contains(node.id()))
+    {
+        updateCost(node.id(), node.cost());
+        return;
+    }
+    if (!isInRegion(node))
+        return;
+
+    if ((unsigned long)node.id() >= _costs.size())
+        _costs.resize(node.id() + 1, NAN);
+    _costs[node.id()] = node.cost();
+    _byCost.insert({ node.cost(), node.id() });
+}
+
+void GoalNodeSet::updateCost(unsigned long id, double cost)
+{
+    if (!contains(id) || _costs[id] == cost)
+        return;
+    _byCost.erase({ _costs[id], id });
+    _byCost.insert({ cost, id });
+    _costs[id] = cost;
+}
+
+void GoalNodeSet::erase(unsigned long id)
+{
+    if (!contains(id))
+        return;
+    _byCost.erase({ _costs[id], id });
+    _costs[id] = NAN;
+}
+
+unsigned long GoalNodeSet::bestId() const { return _byCost.empty() ? 0 : _byCost.begin()->second; }
+
+double GoalNodeSet::bestCost() const { return _byCost.empty() ? INFINITY : _byCost.begin()->first; }
+
+unsigned long GoalNodeSet::size() const { return _byCost.size(); }
+
+void GoalNodeSet::clear()
+{
+    _costs.clear();
+    _byCost.clear();
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include <math.h>
+#include <set>
+#include <vector>
+#include "ConfigspaceNode.hpp"
+#include "Geometry2D.hpp"
+
+using namespace std;
+
+#ifndef GOAL_NODE_SET_H
+#define GOAL_NODE_SET_H
+
+// the configspace nodes in the goal region ordered by their current cost, so the cheapest is
+// always at hand. the region is every state closer than the tolerance to the goal; without a
+// goal the set stays empty
+class GoalNodeSet
+{
+    State _goal;
+    double _tolerance;
+    vector<double> _costs;                  // indexed by node id; NAN for nodes outside the region
+    set<pair<double, unsigned long>> _byCost;
+
+    void _buildGoalNodeSet();
+
+    public:
+        GoalNodeSet();
+
+        // drops the current nodes; they have to be inserted again
+        void setGoal(State goal, double tolerance);
+        bool isInRegion(const State& state) const;
+        bool contains(unsigned long id) const;
+
+        // adds the node if it is in the region, or updates its cost if it is already in the set
+        void insert(const ConfigspaceNode& node);
+        void updateCost(unsigned long id, double cost);
+        void erase(unsigned long id);
+
+        // the cheapest node, or 0 and INFINITY when the set is empty
+        unsigned long bestId() const;
+        double bestCost() const;
+        unsigned long size() const;
+
+        // drops the nodes but keeps the goal
+        void clear();
+};
+
+#endif //GOAL_NODE_SET_H
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include <algorithm>
+#include "KdTree.hpp"
+
+KdTree::KdTree()
+{
+    _buildKdTree();
+    setApproximationError(0);
+}
+
+NodeIndex* KdTree::clone() const
+{
+    return new KdTree(*this);
+}
+
+void KdTree::_buildKdTree()
+{
+    _nodes.clear();
+    _idToIndex.clear();
+    _root = KD_TREE_NULL_INDEX;
+    _maxDepth = 0;
+    _numRemoved = 0;
+}
+
+KdTree::AuditCounters& KdTree::AuditCounters::operator=(const AuditCounters& counters)
+{
+    queries = counters.queries.load();
+    audited = counters.audited.load();
+    inexact = counters.inexact.load();
+    return *this;
+}
+
+void KdTree::_insertIndex(int index)
+{
+    KdNode& node = _nodes[index];
+    node.left = KD_TREE_NULL_INDEX;
+    node.right = KD_TREE_NULL_INDEX;
+
+    if (_root == KD_TREE_NULL_INDEX)
+    {
+        node.axis = 0;
+        _root = index;
+        _maxDepth = max(_maxDepth, 1);
+        return;
+    }
+
+    int current = _root, depth = 1;
+    while (true)
+    {
+        KdNode& parent = _nodes[current];
+        int& child = node.point[parent.axis] < parent.point[parent.axis] ? parent.left : parent.right;
+        ++depth;
+
+        if (child == KD_TREE_NULL_INDEX)
+        {
+            child = index;
+            node.axis = (parent.axis + 1) % 3;
+            _maxDepth = max(_maxDepth, depth);
+            return;
+        }
+        current = child;
+    }
+}
+
+int KdTree::_buildBalanced(vector<int>& indices, int begin, int end, int depth)
+{
+    if (begin >= end)
+        return KD_TREE_NULL_INDEX;
+
+    int axis = depth % 3;
+    int mid = begin + (end - begin) / 2;
+    nth_element(indices.begin() + begin, indices.begin() + mid, indices.begin() + end,
+        [this, axis](int a, int b) { return _nodes[a].point[axis] < _nodes[b].point[axis]; });
+
+    KdNode& node = _nodes[indices[mid]];
+    node.axis = axis;
+    node.left = _buildBalanced(indices, begin, mid, depth + 1);
+    node.right = _buildBalanced(indices, mid + 1, end, depth + 1);
+    _maxDepth = max(_maxDepth, depth + 1);
+
+    return indices[mid];
+}
+
+void KdTree::_rebalance()
+{
+    // compact the node storage, dropping removed nodes
+    vector<KdNode> liveNodes;
+    liveNodes.reserve(_nodes.size() - _numRemoved);
+    for (const KdNode& n : _nodes)
+        if (!n.removed)
+            liveNodes.push_back(n);
+
+    _nodes.swap(liveNodes);
+    _numRemoved = 0;
+    _maxDepth = 0;
+
+    fill(_idToIndex.begin(), _idToIndex.end(), KD_TREE_NULL_INDEX);
+    vector<int> indices(_nodes.size());
+    for (int i = 0; i < (int)_nodes.size(); ++i)
+    {
+        indices[i] = i;
+        _idToIndex[_nodes[i].id] = i;
+    }
+
+    _root = _buildBalanced(indices, 0, indices.size(), 0);
+}
+
+bool KdTree::_needsRebalance() const
+{
+    unsigned long numLive = size();
+    if (numLive < KD_TREE_MIN_REBALANCE_SIZE)
+        return false;
+
+    double balancedDepth = ceil(log2((double)numLive + 1.0));
+    return _maxDepth > KD_TREE_REBALANCE_FACTOR * balancedDepth || _numRemoved > (int)numLive;
+}
+
+bool KdTree::_shouldAudit() const
+{
+    return _auditCounters.queries.fetch_add(1) % KD_TREE_APPROXIMATION_AUDIT_INTERVAL == 0;
+}
+
+void KdTree::_findNearest(int index, const double* point, double pruneScale, int& bestIndex, double& bestDistSq) const
+{
+    if (index == KD_TREE_NULL_INDEX)
+        return;
+
+    const KdNode& node = _nodes[index];
+
+    if (!node.removed)
+    {
+        double dx = node.point[0] - point[0];
+        double dy = node.point[1] - point[1];
+        double dz = node.point[2] - point[2];
+        double distSq = dx * dx + dy * dy + dz * dz;
+        if (distSq < bestDistSq)
+        {
+            bestDistSq = distSq;
+            bestIndex = index;
+        }
+    }
+
+    // search the side of the split containing the point first, then only visit
+    // the far side if the splitting plane is closer than the current best
+    double diff = point[node.axis] - node.point[node.axis];
+    _findNearest(diff < 0 ? node.left : node.right, point, pruneScale, bestIndex, bestDistSq);
+
+    if (diff * diff < bestDistSq * pruneScale)
+        _findNearest(diff < 0 ? node.right : node.left, point, pruneScale, bestIndex, bestDistSq);
+}
+
+void KdTree::_findNearest(int index, const double* point, int k, double maxDistSq, double pruneScale, vector<pair<double, int>>& heap) const
+{
+    if (index == KD_TREE_NULL_INDEX)
+        return;
+
+    const KdNode& node = _nodes[index];
+
+    // the search ball shrinks to the current k-th best distance once the heap is full
+    double boundSq = heap.size() < (size_t)k ? maxDistSq : heap.front().first;
+
+    if (!node.removed)
+    {
+        double dx = node.point[0] - point[0];
+        double dy = node.point[1] - point[1];
+        double dz = node.point[2] - point[2];
+        double distSq = dx * dx + dy * dy + dz * dz;
+        if (distSq < boundSq)
+        {
+            if (heap.size() == (size_t)k)
+            {
+                pop_heap(heap.begin(), heap.end());
+                heap.pop_back();
+            }
+            heap.push_back({ distSq, index });
+            push_heap(heap.begin(), heap.end());
+            boundSq = heap.size() < (size_t)k ? maxDistSq : heap.front().first;
+        }
+    }
+
+    double diff = point[node.axis] - node.point[node.axis];
+    _findNearest(diff < 0 ? node.left : node.right, point, k, maxDistSq, pruneScale, heap);
+
+    boundSq = heap.size() < (size_t)k ? maxDistSq : heap.front().first;
+    if (diff * diff < boundSq * pruneScale)
+        _findNearest(diff < 0 ? node.right : node.left, point, k, maxDistSq, pruneScale, heap);
+}
+
+void KdTree::insert(unsigned long id, const Point& p)
+{
+    if (contains(id))
+        remove(id);
+
+    if (id >= _idToIndex.size())
+        _idToIndex.resize(max((unsigned long)id + 1, (unsigned long)_idToIndex.size() * 2), KD_TREE_NULL_INDEX);
+
+    KdNode node;
+    node.point[0] = p.x();
+    node.point[1] = p.y();
+    node.point[2] = p.z();
+    node.id = id;
+    node.removed = false;
+
+    _nodes.push_back(node);
+    _idToIndex[id] = _nodes.size() - 1;
+    _insertIndex(_nodes.size() - 1);
+
+    if (_needsRebalance())
+        _rebalance();
+}
+
+void KdTree::remove(unsigned long id)
+{
+    if (!contains(id))
+        return;
+
+    // removal is lazy; the node stays in place as a splitting plane until the next rebalance
+    _nodes[_idToIndex[id]].removed = true;
+    _idToIndex[id] = KD_TREE_NULL_INDEX;
+    ++_numRemoved;
+}
+
+void KdTree::update(unsigned long id, const Point& p)
+{
+    if (contains(id))
+    {
+        const KdNode& node = _nodes[_idToIndex[id]];
+        if (node.point[0] == p.x() && node.point[1] == p.y() && node.point[2] == p.z())
+            return;
+    }
+    insert(id, p);
+}
+
+void KdTree::clear()
+{
+    _buildKdTree();
+}
+
+bool KdTree::contains(unsigned long id) const
+{
+    return id < _idToIndex.size() && _idToIndex[id] != KD_TREE_NULL_INDEX;
+}
+
+unsigned long KdTree::size() const { return _nodes.size() - _numRemoved; }
+
+int KdTree::depth() const { return _maxDepth; }
+
+unsigned long KdTree::findNearest(const Point& p) const
+{
+    double point[3] = { p.x(), p.y(), p.z() };
+    double bestDistSq = INFINITY;
+    int bestIndex = KD_TREE_NULL_INDEX;
+
+    _findNearest(_root, point, _pruneScale, bestIndex, bestDistSq);
+
+    if (_approximationError > 0 && _shouldAudit())
+    {
+        double exactDistSq = INFINITY;
+        int exactIndex = KD_TREE_NULL_INDEX;
+        _findNearest(_root, point, 1, exactIndex, exactDistSq);
+
+        ++_auditCounters.audited;
+        if (exactDistSq < bestDistSq)
+            ++_auditCounters.inexact;
+    }
+
+    return bestIndex == KD_TREE_NULL_INDEX ? 0 : _nodes[bestIndex].id;
+}
+
+vector<pair<double, int>> KdTree::_findNearest(const double* point, int k, double radius, double pruneScale) const
+{
+    vector<pair<double, int>> heap;
+    heap.reserve(k);
+    _findNearest(_root, point, k, radius * radius, pruneScale, heap);
+    sort_heap(heap.begin(), heap.end());
+    return heap;
+}
+
+vector<unsigned long> KdTree::findNearest(const Point& p, int k, double radius) const
+{
+    vector<unsigned long> ids;
+    if (k <= 0 || radius <= 0)
+        return ids;
+
+    double point[3] = { p.x(), p.y(), p.z() };
+    auto sorted = _findNearest(point, k, radius, _pruneScale);
+
+    // an approximate answer is inexact if any rank is farther than the exact one at that rank
+    if (_approximationError > 0 && _shouldAudit())
+    {
+        auto exact = _findNearest(point, k, radius, 1);
+        bool isExact = exact.size() == sorted.size();
+        for (size_t i = 0; isExact && i < exact.size(); ++i)
+            isExact = sorted[i].first <= exact[i].first;
+
+        ++_auditCounters.audited;
+        if (!isExact)
+            ++_auditCounters.inexact;
+    }
+
+    ids.reserve(sorted.size());
+    for (auto& entry : sorted)
+        ids.push_back(_nodes[entry.second].id);
+
+    return ids;
+}
+
+void KdTree::setApproximationError(double epsilon)
+{
+    _approximationError = max(epsilon, 0.0);
+    _pruneScale = 1.0 / ((1.0 + _approximationError) * (1.0 + _approximationError));
+    _auditCounters = AuditCounters();
+}
+
+double KdTree::approximationError() const { return _approximationError; }
+
+ApproximateQueryStats KdTree::approximateQueryStats() const
+{
+    if (_approximationError <= 0)
+        return { 0, 0, 0 };
+    return { _auditCounters.queries.load(), _auditCounters.audited.load(), _auditCounters.inexact.load() };
+}
\ No newline at end of file
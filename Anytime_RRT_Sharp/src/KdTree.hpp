@@ -0,0 +1,79 @@
+#include <atomic>
+#include <math.h>
+#include <vector>
+#include "Geometry2D.hpp"
+#include "NodeIndex.hpp"
+
+using namespace std;
+
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#define KD_TREE_NULL_INDEX -1
+#define KD_TREE_REBALANCE_FACTOR 3
+#define KD_TREE_MIN_REBALANCE_SIZE 64
+#define KD_TREE_APPROXIMATION_AUDIT_INTERVAL 32     // every n-th approximate query is repeated exactly to count misses
+
+// incremental 3-d tree over node positions; nodes are stored contiguously and
+// children are referenced by index to keep traversal cache friendly
+class KdTree : public NodeIndex
+{
+    struct KdNode
+    {
+        double point[3];
+        unsigned long id;
+        int left, right;
+        int axis;
+        bool removed;
+    };
+
+    // counters written by const queries; atomic so concurrent readers can share the tree
+    struct AuditCounters
+    {
+        atomic<unsigned long> queries, audited, inexact;
+
+        AuditCounters() : queries(0), audited(0), inexact(0) {}
+        AuditCounters(const AuditCounters& counters) { *this = counters; }
+        AuditCounters& operator=(const AuditCounters& counters);
+    };
+
+    vector<KdNode> _nodes;
+    vector<int> _idToIndex;         // maps node ids to indices in _nodes
+    int _root, _maxDepth, _numRemoved;
+    double _approximationError;
+    double _pruneScale;             // far subtrees are skipped unless closer than the best distance times this
+    mutable AuditCounters _auditCounters;
+
+    void _buildKdTree();
+    void _insertIndex(int index);
+    int _buildBalanced(vector<int>& indices, int begin, int end, int depth);
+    void _rebalance();
+    bool _needsRebalance() const;
+    bool _shouldAudit() const;
+    void _findNearest(int index, const double* point, double pruneScale, int& bestIndex, double& bestDistSq) const;
+    void _findNearest(int index, const double* point, int k, double maxDistSq, double pruneScale, vector<pair<double, int>>& heap) const;
+    vector<pair<double, int>> _findNearest(const double* point, int k, double radius, double pruneScale) const;
+
+    public:
+        KdTree();
+        NodeIndex* clone() const;
+        void insert(unsigned long id, const Point& p);
+        void remove(unsigned long id);
+        void update(unsigned long id, const Point& p);
+        void clear();
+        bool contains(unsigned long id) const;
+        unsigned long size() const;
+        int depth() const;
+        unsigned long findNearest(const Point& p) const;
+
+        // candidates are kept in a bounded max-heap of size k
+        vector<unsigned long> findNearest(const Point& p, int k, double radius) const;
+
+        // (1 + epsilon)-approximate search: a far subtree is only visited if it could hold a node
+        // more than (1 + epsilon) times closer than the current best
+        void setApproximationError(double epsilon);
+        double approximationError() const;
+        ApproximateQueryStats approximateQueryStats() const;
+};
+
+#endif //KD_TREE_H
\ No newline at end of file
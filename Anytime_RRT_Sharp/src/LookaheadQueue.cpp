@@ -0,0 +1,101 @@
+#include "LookaheadQueue.hpp"
+
+LookaheadQueue::LookaheadQueue()
+{
+    _buildLookaheadQueue();
+}
+
+void LookaheadQueue::_buildLookaheadQueue()
+{
+    _lookaheads.clear();
+    _queuedKeys.clear();
+    _heap = priority_queue<Entry, vector<Entry>, greater<Entry>>();
+    _size = 0;
+    _goal = State();
+    _goalTolerance = 0;
+}
+
+void LookaheadQueue::_reserve(unsigned long id)
+{
+    if (id < _lookaheads.size())
+        return;
+    _lookaheads.resize(id + 1, { INFINITY, 0, 0 });
+    _queuedKeys.resize(id + 1, INFINITY);
+}
+
+void LookaheadQueue::_dropStaleEntries()
+{
+    // entries whose node was requeued or popped since they were pushed
+    while (!_heap.empty() && _queuedKeys[_heap.top().second] != _heap.top().first)
+        _heap.pop();
+}
+
+void LookaheadQueue::setGoal(State goal, double tolerance)
+{
+    _goal = goal;
+    _goalTolerance = tolerance;
+}
+
+double LookaheadQueue::costToGoalLowerBound(const State& state) const
+{
+    return max(0.0, state.distanceTo(_goal) - _goalTolerance);
+}
+
+const Lookahead& LookaheadQueue::lookahead(unsigned long id)
+{
+    _reserve(id);
+    return _lookaheads[id];
+}
+
+bool LookaheadQueue::relax(unsigned long id, double cost, unsigned long parentId, double pathLength)
+{
+    _reserve(id);
+    if (cost >= _lookaheads[id].cost)
+        return false;
+    _lookaheads[id] = { cost, pathLength, parentId };
+    return true;
+}
+
+void LookaheadQueue::push(const GraphNode& node)
+{
+    unsigned long id = node.id();
+    _reserve(id);
+
+    double key = _lookaheads[id].cost + costToGoalLowerBound(node);
+    if (isinf(key))
+        return;
+    if (isinf(_queuedKeys[id]))
+        ++_size;
+    _queuedKeys[id] = key;
+    _heap.push({ key, id });
+}
+
+unsigned long LookaheadQueue::pop()
+{
+    _dropStaleEntries();
+    if (_heap.empty())
+        return 0;
+
+    unsigned long id = _heap.top().second;
+    _heap.pop();
+    _queuedKeys[id] = INFINITY;
+    --_size;
+    return id;
+}
+
+double LookaheadQueue::topKey()
+{
+    _dropStaleEntries();
+    return _heap.empty() ? INFINITY : _heap.top().first;
+}
+
+bool LookaheadQueue::isQueued(unsigned long id) const { return id < _queuedKeys.size() && !isinf(_queuedKeys[id]); }
+
+bool LookaheadQueue::empty() const { return !_size; }
+
+unsigned long LookaheadQueue::size() const { return _size; }
+
+void LookaheadQueue::clear()
+{
+    _buildLookaheadQueue();
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include <math.h>
+#include <queue>
+#include <vector>
+#include "Geometry2D.hpp"
+
+using namespace std;
+
+#ifndef LOOKAHEAD_QUEUE_H
+#define LOOKAHEAD_QUEUE_H
+
+// the best known way to reach a node: the cost through parentId and the length of the
+// maneuver from it. INFINITY cost when nothing has been recorded
+struct Lookahead
+{
+    double cost, pathLength;
+    unsigned long parentId;
+};
+
+// one-step lookahead costs (lmc) of the configspace nodes and a min queue of the inconsistent
+// ones, keyed on the lookahead cost plus an admissible estimate of the cost to the goal.
+// a node is requeued by pushing it again; the older heap entry is skipped when it surfaces
+class LookaheadQueue
+{
+    typedef pair<double, unsigned long> Entry;
+
+    vector<Lookahead> _lookaheads;      // indexed by node id
+    vector<double> _queuedKeys;         // key of the live heap entry of each node; INFINITY when not queued
+    priority_queue<Entry, vector<Entry>, greater<Entry>> _heap;
+    unsigned long _size;
+    State _goal;
+    double _goalTolerance;
+
+    void _buildLookaheadQueue();
+    void _reserve(unsigned long id);
+    void _dropStaleEntries();
+
+    public:
+        LookaheadQueue();
+
+        // states within tolerance of the goal are at the goal, so the estimate is the straight
+        // line distance less the tolerance
+        void setGoal(State goal, double tolerance);
+        double costToGoalLowerBound(const State& state) const;
+
+        const Lookahead& lookahead(unsigned long id);
+
+        // records the cost through parentId if it is lower than the known lookahead cost
+        bool relax(unsigned long id, double cost, unsigned long parentId, double pathLength);
+
+        // queues the node on its lookahead cost, replacing any entry it already has; nodes without
+        // a lookahead cost are not queued
+        void push(const GraphNode& node);
+        unsigned long pop();
+        double topKey();
+        bool isQueued(unsigned long id) const;
+        bool empty() const;
+        unsigned long size() const;
+        void clear();
+};
+
+#endif //LOOKAHEAD_QUEUE_H
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include <cstring>
+#include "ManeuverCache.hpp"
+
+ManeuverKey::ManeuverKey(const State& start, const State& final)
+{
+    double values[MANEUVER_KEY_SIZE] = {
+        start.x(), start.y(), start.z(), start.theta(), start.rho(),
+        final.x(), final.y(), final.z(), final.theta(), final.rho()
+    };
+    memcpy(bits, values, sizeof(bits));
+}
+
+bool ManeuverKey::operator==(const ManeuverKey& key) const
+{
+    return memcmp(bits, key.bits, sizeof(bits)) == 0;
+}
+
+size_t maneuver_key_hash::operator()(const ManeuverKey& key) const
+{
+    unsigned long long h = 0x9e3779b97f4a7c15ull;
+    for (int i = 0; i < MANEUVER_KEY_SIZE; ++i)
+    {
+        h ^= key.bits[i];
+        h += 0x9e3779b97f4a7c15ull;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+        h ^= h >> 31;
+    }
+    return h;
+}
+
+ManeuverCache::ManeuverCache(unsigned long capacityBytes)
+{
+    _buildManeuverCache(capacityBytes);
+}
+
+void ManeuverCache::_buildManeuverCache(unsigned long capacityBytes)
+{
+    _entries.clear();
+    _index.clear();
+    _capacityBytes = capacityBytes;
+    _bytes = 0;
+    _hits = 0;
+    _misses = 0;
+    _evictions = 0;
+}
+
+unsigned long ManeuverCache::_entryBytes(const Entry& entry) const
+{
+    // list node, hash node and the sampled path; bucket arrays are not counted
+    return sizeof(Entry) + 2 * sizeof(void*) + sizeof(ManeuverKey) + 3 * sizeof(void*) + entry.path.capacity() * sizeof(State);
+}
+
+ManeuverCache::Entry* ManeuverCache::_find(const ManeuverKey& key)
+{
+    auto itr = _index.find(key);
+    if (itr == _index.end())
+        return nullptr;
+
+    _entries.splice(_entries.begin(), _entries, itr->second);
+    return &*itr->second;
+}
+
+void ManeuverCache::_insert(const ManeuverKey& key, double length, const vector<State>* path)
+{
+    if (!_capacityBytes)
+        return;
+
+    Entry* entry = _find(key);
+    if (!entry)
+    {
+        _entries.push_front({ key, length, vector<State>(), false });
+        _index[key] = _entries.begin();
+        entry = &_entries.front();
+        _bytes += _entryBytes(*entry);
+    }
+
+    if (path && !entry->hasPath)
+    {
+        _bytes -= _entryBytes(*entry);
+        entry->path = *path;
+        entry->hasPath = true;
+        _bytes += _entryBytes(*entry);
+    }
+    entry->length = length;
+
+    _evictToCapacity();
+}
+
+void ManeuverCache::_evictToCapacity()
+{
+    while (_bytes > _capacityBytes && !_entries.empty())
+    {
+        Entry& oldest = _entries.back();
+        _bytes -= _entryBytes(oldest);
+        _index.erase(oldest.key);
+        _entries.pop_back();
+        ++_evictions;
+    }
+}
+
+bool ManeuverCache::findLength(const State& start, const State& final, double& length)
+{
+    lock_guard<mutex> lock(_mutex);
+    Entry* entry = _find(ManeuverKey(start, final));
+    if (!entry)
+    {
+        ++_misses;
+        return false;
+    }
+
+    ++_hits;
+    length = entry->length;
+    return true;
+}
+
+bool ManeuverCache::findPath(const State& start, const State& final, vector<State>& path)
+{
+    lock_guard<mutex> lock(_mutex);
+    Entry* entry = _find(ManeuverKey(start, final));
+    if (!entry || !entry->hasPath)
+    {
+        ++_misses;
+        return false;
+    }
+
+    ++_hits;
+    path = entry->path;
+    return true;
+}
+
+void ManeuverCache::insert(const State& start, const State& final, double length)
+{
+    lock_guard<mutex> lock(_mutex);
+    _insert(ManeuverKey(start, final), length, nullptr);
+}
+
+void ManeuverCache::insert(const State& start, const State& final, double length, const vector<State>& path)
+{
+    lock_guard<mutex> lock(_mutex);
+    _insert(ManeuverKey(start, final), length, &path);
+}
+
+void ManeuverCache::setCapacity(unsigned long capacityBytes)
+{
+    lock_guard<mutex> lock(_mutex);
+    _capacityBytes = capacityBytes;
+    _evictToCapacity();
+}
+
+unsigned long ManeuverCache::capacity() const { return _capacityBytes; }
+
+bool ManeuverCache::enabled() const { return _capacityBytes > 0; }
+
+void ManeuverCache::clear()
+{
+    lock_guard<mutex> lock(_mutex);
+    _entries.clear();
+    _index.clear();
+    _bytes = 0;
+}
+
+ManeuverCacheStats ManeuverCache::stats() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return { _hits, _misses, _evictions, (unsigned long)_entries.size(), _bytes };
+}
+
+void ManeuverCache::resetStats()
+{
+    lock_guard<mutex> lock(_mutex);
+    _hits = 0;
+    _misses = 0;
+    _evictions = 0;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "Geometry2D.hpp"
+
+using namespace std;
+
+#ifndef MANEUVER_CACHE_H
+#define MANEUVER_CACHE_H
+
+#define DEFAULT_MANEUVER_CACHE_BYTES (64ul << 20)
+#define MANEUVER_KEY_SIZE 10
+
+// the exact bits of the start and final states; order matters since maneuvers are directed
+struct ManeuverKey
+{
+    unsigned long long bits[MANEUVER_KEY_SIZE];
+
+    ManeuverKey(const State& start, const State& final);
+    bool operator==(const ManeuverKey& key) const;
+};
+
+// mixes every state word through splitmix64 so (a, b) and (b, a) and nearby states spread out
+struct maneuver_key_hash
+{
+    size_t operator()(const ManeuverKey& key) const;
+};
+
+struct ManeuverCacheStats
+{
+    unsigned long hits, misses, evictions, entries, bytes;
+};
+
+// memory bounded lru cache of maneuver lengths and, once requested, their sampled paths.
+// lookups and inserts lock a mutex so planner threads can share it
+class ManeuverCache
+{
+    struct Entry
+    {
+        ManeuverKey key;
+        double length;
+        vector<State> path;
+        bool hasPath;
+    };
+
+    list<Entry> _entries;                   // most recently used first
+    unordered_map<ManeuverKey, list<Entry>::iterator, maneuver_key_hash> _index;
+    unsigned long _capacityBytes, _bytes;
+    unsigned long _hits, _misses, _evictions;
+    mutable mutex _mutex;
+
+    void _buildManeuverCache(unsigned long capacityBytes);
+    unsigned long _entryBytes(const Entry& entry) const;
+    Entry* _find(const ManeuverKey& key);
+    void _insert(const ManeuverKey& key, double length, const vector<State>* path);
+    void _evictToCapacity();
+
+    public:
+        ManeuverCache(unsigned long capacityBytes = DEFAULT_MANEUVER_CACHE_BYTES);
+
+        // return true and fill in the result on a hit; a length-only entry misses findPath
+        bool findLength(const State& start, const State& final, double& length);
+        bool findPath(const State& start, const State& final, vector<State>& path);
+
+        void insert(const State& start, const State& final, double length);
+        void insert(const State& start, const State& final, double length, const vector<State>& path);
+
+        // a capacity of 0 disables the cache
+        void setCapacity(unsigned long capacityBytes);
+        unsigned long capacity() const;
+        bool enabled() const;
+        void clear();
+        ManeuverCacheStats stats() const;
+        void resetStats();
+};
+
+#endif //MANEUVER_CACHE_H
\ No newline at end of file
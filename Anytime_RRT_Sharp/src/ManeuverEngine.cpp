@@ -1,17 +1,21 @@
+#include <algorithm>
 #include "ManeuverEngine.hpp"
 
-maneuverMap ManeuverEngine::_maneuverMap;
+ManeuverCache ManeuverEngine::_maneuverCache;
+
+double ManeuverEngine::_maxSampleStep = 0;
 
 ManeuverType ManeuverEngine::maneuverType;
 
 vector<State> ManeuverEngine::_generateDirectLinePath(const State& start, const State& final)
 {
     Line line(start, final);
-    vector<State> path(NUM_SAMPLES);
+    int numSamples = sampleCount(line.length());
+    vector<State> path(numSamples);
     Vector deltaVec;
-    double delta = line.length() / (double)NUM_SAMPLES;
+    double delta = line.length() / (double)numSamples;
     
-    for (int i = 0; i < NUM_SAMPLES; ++i)
+    for (int i = 0; i < numSamples; ++i)
     {
         deltaVec = line.tangent() * i * delta;
         path[i] = State(start.x() + deltaVec.x(), start.y() + deltaVec.y(), start.z() + deltaVec.z(), final.theta(), final.rho());
@@ -27,53 +31,75 @@ double ManeuverEngine::_getDirectLinePathLength(const State& start, const State&
 
 vector<State> ManeuverEngine::_generateDubinsPath(const State& start, const State& final)
 {
-    DubinsData dubinsData = _generateDubinsData(start, final);
-    return dubinsData.path;
+    vector<State> path;
+    bool useCache = _maneuverCache.enabled();
+    if (useCache && _maneuverCache.findPath(start, final, path))
+        return path;
+
+    DubinsManeuver3d maneuver = _buildDubinsManeuver(start, final);
+    path = _sampleDubinsManeuver(maneuver, sampleCount(maneuver.length(), true));
+    if (useCache)
+        _maneuverCache.insert(start, final, maneuver.length(), path);
+    return path;
 }
 
 double ManeuverEngine::_getDubinsPathLength(const State& start, const State& final)
 {
-    DubinsData dubinsData = _generateDubinsData(start, final);
-    return dubinsData.maneuver.length();
+    // cost-only fast path: the maneuver is built but never sampled, and lengths are cached
+    // without samples since most evaluated edges are never checked for safety
+    double length;
+    bool useCache = _maneuverCache.enabled();
+    if (useCache && _maneuverCache.findLength(start, final, length))
+        return length;
+
+    length = _buildDubinsManeuver(start, final).length();
+    if (useCache)
+        _maneuverCache.insert(start, final, length);
+    return length;
 }
 
-DubinsData ManeuverEngine::_generateDubinsData(const State& start, const State& final)
+double ManeuverEngine::_getDubinsPathLengthLowerBound(const State& start, const State& final)
 {
-    State3d qi { start.x(), start.y(), start.z(), start.theta(), start.rho() };
-    State3d qf { final.x(), final.y(), final.z(), final.theta(), final.rho() };
-
-    DubinsManeuver3d maneuver(qi, qf, RHO_MIN, { PITCH_MIN_DEG, PITCH_MAX_DEG });
-    vector<State> path;
-
-    if (maneuver.length() > 0)
-    {
-        path.resize(NUM_SAMPLES);
-        auto dubinsStates = maneuver.computeSampling(NUM_SAMPLES);
-        for (int i = 0; i < NUM_SAMPLES; ++i)
-            path[i] = State(dubinsStates.at(i).x, dubinsStates.at(i).y, dubinsStates.at(i).z, dubinsStates.at(i).theta, dubinsStates.at(i).gamma);
-    }
-
-    return { maneuver, path };
+    double dx = final.x() - start.x();
+    double dy = final.y() - start.y();
+    double dz = final.z() - start.z();
+
+    // the horizontal projection has to cover the planar distance, turn through the heading
+    // change at no less than RHO_MIN, and be long enough to climb dz within the pitch limits
+    double headingChange = fmod(abs(final.theta() - start.theta()), 2.0 * M_PI);
+    headingChange = headingChange > M_PI ? 2.0 * M_PI - headingChange : headingChange;
+    double maxPitch = dz >= 0 ? PITCH_MAX_DEG : -(PITCH_MIN_DEG);
+
+    double horizontalLength = max({ sqrt(dx * dx + dy * dy), RHO_MIN * headingChange, abs(dz) / tan(maxPitch) });
+    return sqrt(horizontalLength * horizontalLength + dz * dz);
 }
 
-bool ManeuverEngine::_maneuverNotInMap(const GraphNode& start, const GraphNode& final)
+DubinsManeuver3d ManeuverEngine::_buildDubinsManeuver(const State& start, const State& final)
 {
-    auto mapItr = _maneuverMap.find(make_tuple(start.id(), final.id()));
-    return mapItr == _maneuverMap.end();
+    State3d qi { start.x(), start.y(), start.z(), start.theta(), start.rho() };
+    State3d qf { final.x(), final.y(), final.z(), final.theta(), final.rho() };
+
+    return DubinsManeuver3d(qi, qf, RHO_MIN, { PITCH_MIN_DEG, PITCH_MAX_DEG });
 }
 
-void ManeuverEngine::_addManeuverToMap(const GraphNode& start, const GraphNode& final)
+vector<State> ManeuverEngine::_sampleDubinsManeuver(const DubinsManeuver3d& maneuver, int numSamples)
 {
-    DubinsData dubinsData = _generateDubinsData(start, final);
-    _maneuverMap[make_tuple(start.id(), final.id())] = dubinsData;
+    vector<State> path;
+    _sampleDubinsManeuver(maneuver, numSamples, path);
+    return path;
 }
 
-vector<State> ManeuverEngine::generatePathUsingMap(const GraphNode& start, const GraphNode& final)
+void ManeuverEngine::_sampleDubinsManeuver(const DubinsManeuver3d& maneuver, int numSamples, vector<State>& path)
 {
-    if (_maneuverNotInMap(start, final))
-        _addManeuverToMap(start, final);
-
-    return _maneuverMap[make_tuple(start.id(), final.id())].path;
+    // resizing keeps the capacity, so a reused path only allocates when it has to grow
+    path.clear();
+    if (maneuver.length() > 0)
+    {
+        path.resize(numSamples);
+        auto dubinsStates = maneuver.computeSampling(numSamples);
+        for (int i = 0; i < numSamples; ++i)
+            path[i] = State(dubinsStates.at(i).x, dubinsStates.at(i).y, dubinsStates.at(i).z, dubinsStates.at(i).theta, dubinsStates.at(i).gamma);
+    }
 }
 
 vector<State> ManeuverEngine::generatePath(const State& start, const State& final)
@@ -92,17 +118,46 @@ double ManeuverEngine::getPathLength(const State& start, const State& final)
         return _getDirectLinePathLength(start, final);
 }
 
+double ManeuverEngine::getPathLengthLowerBound(const State& start, const State& final)
+{
+    if (maneuverType == Dubins3d)
+        return _getDubinsPathLengthLowerBound(start, final);
+    return _getDirectLinePathLength(start, final);
+}
+
 double ManeuverEngine::getRhoChange(const State& start, const State& final)
 {
     if (maneuverType == Dubins3d)
     {
-        DubinsData dubinsData = _generateDubinsData(start, final);
+        auto path = _generateDubinsPath(start, final);
         double totalChange = 0;
-        int numStates = dubinsData.path.size();
+        int numStates = path.size();
         for (int i = 1; i < numStates; i++)
-            totalChange += abs(dubinsData.path[i].rho() - dubinsData.path[i - 1].rho());
+            totalChange += abs(path[i].rho() - path[i - 1].rho());
         return totalChange;
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+void ManeuverEngine::setMaxSampleStep(double step)
+{
+    // cached paths were sampled at the old spacing
+    if (step != _maxSampleStep)
+        _maneuverCache.clear();
+    _maxSampleStep = max(step, 0.0);
+}
+
+double ManeuverEngine::maxSampleStep() { return _maxSampleStep; }
+
+int ManeuverEngine::sampleCount(double length, bool includesFinal)
+{
+    if (_maxSampleStep <= 0)
+        return NUM_SAMPLES;
+
+    // n samples split the path into n intervals, or n - 1 when both end states are sampled
+    double numSamples = ceil(length / _maxSampleStep) + (includesFinal ? 1 : 0);
+    return (int)min(max(numSamples, (double)MIN_SAMPLES), (double)MAX_SAMPLES);
+}
+
+ManeuverCache& ManeuverEngine::maneuverCache() { return _maneuverCache; }
\ No newline at end of file
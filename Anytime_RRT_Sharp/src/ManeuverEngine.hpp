@@ -1,7 +1,7 @@
 #include <vector>
-#include <unordered_map>
 #include "math.h"
 #include "Dubins3d/src/DubinsManeuver3d.hpp"
+#include "ManeuverCache.hpp"
 #include "Geometry2D.hpp"
 
 using namespace std;
@@ -9,37 +9,13 @@ using namespace std;
 #ifndef MANEUVER_ENGINE_H
 #define MANEUVER_ENGINE_H
 
-#define NUM_SAMPLES 100
+#define NUM_SAMPLES 100      // samples per maneuver when no max sample step is set
+#define MIN_SAMPLES 2
+#define MAX_SAMPLES 2000
 #define RHO_MIN 5
 #define PITCH_MIN_DEG -30.0 * M_PI / 180.0
 #define PITCH_MAX_DEG 30.0 * M_PI / 180.0
 
-typedef tuple<int, int> id_key_t;
-
-struct key_hash : public unary_function<id_key_t, size_t>
-{
-    size_t operator()(const id_key_t& k) const
-    {
-        return get<0>(k) ^ get<1>(k);
-    }
-};
-
-struct key_equal : public binary_function<id_key_t, id_key_t, bool>
-{
-   bool operator()(const id_key_t& v0, const id_key_t& v1) const
-   {
-      return (get<0>(v0) == get<0>(v1) && get<1>(v0) == get<1>(v1));
-   }
-};
-
-struct DubinsData
-{
-    DubinsManeuver3d maneuver;
-    vector<State> path;
-};
-
-typedef unordered_map<const id_key_t, DubinsData, key_hash, key_equal> maneuverMap;
-
 enum ManeuverType
 {
     DirectPath,
@@ -47,24 +23,40 @@ enum ManeuverType
 };
 class ManeuverEngine
 {
-    static maneuverMap _maneuverMap;
+    static ManeuverCache _maneuverCache;
+    static double _maxSampleStep;
 
     static vector<State> _generateDirectLinePath(const State& start, const State& final);
     static double _getDirectLinePathLength(const State& start, const State& final);
 
     static vector<State> _generateDubinsPath(const State& start, const State& final);
-    static DubinsData _generateDubinsData(const State& start, const State& final);
+    static DubinsManeuver3d _buildDubinsManeuver(const State& start, const State& final);
+    static vector<State> _sampleDubinsManeuver(const DubinsManeuver3d& maneuver, int numSamples);
+    static void _sampleDubinsManeuver(const DubinsManeuver3d& maneuver, int numSamples, vector<State>& path);
     static double _getDubinsPathLength(const State& start, const State& final);
+    static double _getDubinsPathLengthLowerBound(const State& start, const State& final);
 
-    static bool _maneuverNotInMap(const GraphNode& start, const GraphNode& final);
-    static void _addManeuverToMap(const GraphNode& start, const GraphNode& final);
+    friend class ManeuverEvaluation;
+    friend class WorkspaceGraph;
 
     public:
         static ManeuverType maneuverType;
         static vector<State> generatePath(const State& start, const State& final);
-        static vector<State> generatePathUsingMap(const GraphNode& start, const GraphNode& final);
         static double getPathLength(const State& start, const State& final);
+
+        // cheap admissible lower bound on getPathLength; never constructs a maneuver
+        static double getPathLengthLowerBound(const State& start, const State& final);
         static double getRhoChange(const State& start, const State& final);
+
+        // paths are sampled no further apart than the max step, so short edges get a handful of
+        // samples and long edges enough for safety; a step of 0 uses a fixed NUM_SAMPLES per path.
+        // a path that also samples its final state needs one sample more for the same spacing
+        static void setMaxSampleStep(double step);
+        static double maxSampleStep();
+        static int sampleCount(double length, bool includesFinal = false);
+
+        // Dubins3d lengths and paths are memoized here by their exact end states
+        static ManeuverCache& maneuverCache();
 };
 
 #endif //MANEUVER_ENGINE_H
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "ManeuverEvaluation.hpp"
+
+atomic<unsigned long> ManeuverEvaluation::_numRequests(0);
+atomic<unsigned long> ManeuverEvaluation::_numConstructions(0);
+
+ManeuverEvaluation::ManeuverEvaluation(const State& start, const State& final)
+{
+    _buildManeuverEvaluation(start, final);
+}
+
+void ManeuverEvaluation::_buildManeuverEvaluation(const State& start, const State& final)
+{
+    _start = start;
+    _final = final;
+    _maneuverType = ManeuverEngine::maneuverType;
+    _length = 0;
+    _hasLength = false;
+    _hasPath = false;
+    _hasSafety = false;
+    _isSafe = false;
+}
+
+void ManeuverEvaluation::_countRequest()
+{
+    if (_maneuverType == Dubins3d)
+        ++_numRequests;
+}
+
+void ManeuverEvaluation::_constructManeuver()
+{
+    if (_dubinsManeuver || (_hasLength && _maneuverType != Dubins3d))
+        return;
+
+    if (_maneuverType == Dubins3d)
+    {
+        ++_numConstructions;
+        _dubinsManeuver = ManeuverEngine::_buildDubinsManeuver(_start, _final);
+        _length = _dubinsManeuver->length();
+    }
+    else
+        _length = ManeuverEngine::_getDirectLinePathLength(_start, _final);
+    _hasLength = true;
+}
+
+void ManeuverEvaluation::_findLength()
+{
+    if (_hasLength)
+        return;
+
+    // edges seen in earlier iterations are answered by the maneuver cache
+    bool useCache = _maneuverType == Dubins3d && ManeuverEngine::_maneuverCache.enabled();
+    if (useCache && ManeuverEngine::_maneuverCache.findLength(_start, _final, _length))
+    {
+        _hasLength = true;
+        return;
+    }
+
+    _constructManeuver();
+    if (useCache)
+        ManeuverEngine::_maneuverCache.insert(_start, _final, _length);
+}
+
+bool ManeuverEvaluation::matches(const State& start, const State& final) const
+{
+    return _start.x() == start.x() && _start.y() == start.y() && _start.z() == start.z() &&
+        _start.theta() == start.theta() && _start.rho() == start.rho() &&
+        _final.x() == final.x() && _final.y() == final.y() && _final.z() == final.z() &&
+        _final.theta() == final.theta() && _final.rho() == final.rho();
+}
+
+double ManeuverEvaluation::length()
+{
+    _countRequest();
+    _findLength();
+    return _length;
+}
+
+const vector<State>& ManeuverEvaluation::path()
+{
+    _countRequest();
+    if (_hasPath)
+        return _path;
+
+    if (_maneuverType == Dubins3d)
+    {
+        bool useCache = ManeuverEngine::_maneuverCache.enabled();
+        if (!useCache || !ManeuverEngine::_maneuverCache.findPath(_start, _final, _path))
+        {
+            _constructManeuver();
+            _path = ManeuverEngine::_sampleDubinsManeuver(*_dubinsManeuver, ManeuverEngine::sampleCount(_length, true));
+            if (useCache)
+                ManeuverEngine::_maneuverCache.insert(_start, _final, _length, _path);
+        }
+    }
+    else
+        _path = ManeuverEngine::_generateDirectLinePath(_start, _final);
+
+    _hasPath = true;
+    return _path;
+}
+
+bool ManeuverEvaluation::isSafe(const WorkspaceGraph& workGraph)
+{
+    _countRequest();
+    if (!_hasSafety)
+    {
+        // straight edges are checked exactly and Dubins edges against bounds on their samples,
+        // so neither needs the full sampled path
+        if (_maneuverType == Dubins3d)
+        {
+            _constructManeuver();
+            _isSafe = workGraph.maneuverIsSafe(*_dubinsManeuver);
+        }
+        else
+            _isSafe = workGraph.segmentIsSafe(_start, _final);
+        _hasSafety = true;
+    }
+    return _isSafe;
+}
+
+ManeuverEvaluationStats ManeuverEvaluation::stats() { return { _numRequests.load(), _numConstructions.load() }; }
+
+void ManeuverEvaluation::resetStats()
+{
+    _numRequests = 0;
+    _numConstructions = 0;
+}
+
+ManeuverEvaluation& ManeuverEvaluationCache::evaluate(const State& start, const State& final)
+{
+    // an iteration only touches a handful of edges, so a linear scan beats hashing
+    for (auto& evaluation : _evaluations)
+        if (evaluation.matches(start, final))
+            return evaluation;
+
+    _evaluations.emplace_back(start, final);
+    return _evaluations.back();
+}
+
+void ManeuverEvaluationCache::clear() { _evaluations.clear(); }
+
+unsigned long ManeuverEvaluationCache::size() const { return _evaluations.size(); }
\ No newline at end of file
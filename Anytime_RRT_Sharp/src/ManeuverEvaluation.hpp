@@ -0,0 +1,64 @@
+#include <atomic>
+#include <deque>
+#include <optional>
+#include <vector>
+#include "ManeuverEngine.hpp"
+#include "Geometry2D.hpp"
+#include "WorkspaceGraph.hpp"
+
+using namespace std;
+
+#ifndef MANEUVER_EVALUATION_H
+#define MANEUVER_EVALUATION_H
+
+// requests answered by maneuver evaluations and the maneuvers they had to construct; without
+// evaluations every request would have constructed its own maneuver. Only Dubins3d edges are
+// counted, since a DirectPath edge has no maneuver to construct
+struct ManeuverEvaluationStats
+{
+    unsigned long requests, constructions;
+};
+
+// everything the planner asks about one candidate edge: the maneuver from start to final is
+// constructed on the first request and its length, samples and safety are kept for later ones
+class ManeuverEvaluation
+{
+    static atomic<unsigned long> _numRequests, _numConstructions;
+
+    State _start, _final;
+    ManeuverType _maneuverType;
+    optional<DubinsManeuver3d> _dubinsManeuver;
+    vector<State> _path;
+    double _length;
+    bool _hasLength, _hasPath, _hasSafety, _isSafe;
+
+    void _buildManeuverEvaluation(const State& start, const State& final);
+    void _countRequest();
+    void _constructManeuver();
+    void _findLength();
+
+    public:
+        ManeuverEvaluation(const State& start, const State& final);
+        bool matches(const State& start, const State& final) const;
+        double length();
+        const vector<State>& path();
+        bool isSafe(const WorkspaceGraph& workGraph);
+
+        static ManeuverEvaluationStats stats();
+        static void resetStats();
+};
+
+// evaluations of the edges considered during a single planner iteration; references returned
+// by evaluate stay valid until the cache is cleared
+class ManeuverEvaluationCache
+{
+    deque<ManeuverEvaluation> _evaluations;
+
+    public:
+        // returns the evaluation of the maneuver from start to final, creating it on first use
+        ManeuverEvaluation& evaluate(const State& start, const State& final);
+        void clear();
+        unsigned long size() const;
+};
+
+#endif //MANEUVER_EVALUATION_H
\ No newline at end of file
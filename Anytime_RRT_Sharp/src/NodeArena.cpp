@@ -0,0 +1,97 @@
+#include <stdexcept>
+#include "NodeArena.hpp"
+
+NodeArena::NodeArena()
+{
+    _buildNodeArena();
+}
+
+NodeArena::NodeArena(const NodeArena& arena)
+{
+    *this = arena;
+}
+
+NodeArena& NodeArena::operator=(const NodeArena& arena)
+{
+    if (this == &arena)
+        return *this;
+
+    _chunks.clear();
+    for (auto& chunk : arena._chunks)
+    {
+        _chunks.emplace_back(new ConfigspaceNode[NODE_ARENA_CHUNK_SIZE]);
+        copy(chunk.get(), chunk.get() + NODE_ARENA_CHUNK_SIZE, _chunks.back().get());
+    }
+    _occupied = arena._occupied;
+    _size = arena._size;
+    return *this;
+}
+
+void NodeArena::_buildNodeArena()
+{
+    // the first chunk always exists so the sentinel in slot 0 can be read
+    _chunks.clear();
+    _chunks.emplace_back(new ConfigspaceNode[NODE_ARENA_CHUNK_SIZE]);
+    _occupied.assign(1, false);
+    _size = 0;
+}
+
+void NodeArena::_reserveSlot(unsigned long id)
+{
+    while (id >= capacity())
+        _chunks.emplace_back(new ConfigspaceNode[NODE_ARENA_CHUNK_SIZE]);
+    if (id >= _occupied.size())
+        _occupied.resize(id + 1, false);
+}
+
+ConfigspaceNode& NodeArena::at(unsigned long id)
+{
+    if (!contains(id))
+        throw out_of_range("NodeArena::at: no node with id " + to_string(id));
+    return (*this)[id];
+}
+
+const ConfigspaceNode& NodeArena::at(unsigned long id) const
+{
+    if (!contains(id))
+        throw out_of_range("NodeArena::at: no node with id " + to_string(id));
+    return (*this)[id];
+}
+
+ConfigspaceNode& NodeArena::insert(const ConfigspaceNode& node)
+{
+    unsigned long id = node.id();
+    _reserveSlot(id);
+    if (!_occupied[id])
+    {
+        _occupied[id] = true;
+        ++_size;
+    }
+    return (*this)[id] = node;
+}
+
+void NodeArena::erase(unsigned long id)
+{
+    if (!contains(id))
+        return;
+
+    (*this)[id] = ConfigspaceNode();
+    _occupied[id] = false;
+    --_size;
+}
+
+void NodeArena::clear()
+{
+    _buildNodeArena();
+}
+
+bool NodeArena::contains(unsigned long id) const
+{
+    return id < _occupied.size() && _occupied[id];
+}
+
+bool NodeArena::empty() const { return _size == 0; }
+
+unsigned long NodeArena::size() const { return _size; }
+
+unsigned long NodeArena::capacity() const { return _chunks.size() * NODE_ARENA_CHUNK_SIZE; }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include <memory>
+#include <vector>
+#include "ConfigspaceNode.hpp"
+
+using namespace std;
+
+#ifndef NODE_ARENA_H
+#define NODE_ARENA_H
+
+#define NODE_ARENA_CHUNK_BITS 10
+#define NODE_ARENA_CHUNK_SIZE (1ul << NODE_ARENA_CHUNK_BITS)
+#define NODE_ARENA_CHUNK_MASK (NODE_ARENA_CHUNK_SIZE - 1)
+
+// dense storage for configspace nodes where a node's id is its slot. nodes live in fixed
+// size chunks that never move, so references stay valid while the arena grows; they are
+// only invalidated by erasing that node or clearing the arena. slot 0 is a default node
+// that is never occupied, matching parent id 0 meaning "no parent"
+class NodeArena
+{
+    vector<unique_ptr<ConfigspaceNode[]>> _chunks;
+    vector<char> _occupied;
+    unsigned long _size;
+
+    void _buildNodeArena();
+    void _reserveSlot(unsigned long id);
+
+    public:
+        template <typename Arena, typename Node>
+        class Iterator
+        {
+            Arena* _arena;
+            unsigned long _id;
+
+            void _skipEmpty() { while (_id < _arena->_occupied.size() && !_arena->_occupied[_id]) ++_id; }
+
+            public:
+                Iterator(Arena* arena, unsigned long id) : _arena(arena), _id(id) { _skipEmpty(); }
+                Node& operator*() const { return (*_arena)[_id]; }
+                Node* operator->() const { return &(*_arena)[_id]; }
+                Iterator& operator++() { ++_id; _skipEmpty(); return *this; }
+                bool operator==(const Iterator& other) const { return _id == other._id; }
+                bool operator!=(const Iterator& other) const { return _id != other._id; }
+        };
+        typedef Iterator<NodeArena, ConfigspaceNode> iterator;
+        typedef Iterator<const NodeArena, const ConfigspaceNode> const_iterator;
+
+        NodeArena();
+        NodeArena(const NodeArena& arena);
+        NodeArena& operator=(const NodeArena& arena);
+
+        // unchecked lookup by id; ids past the last allocated chunk are not allowed
+        ConfigspaceNode& operator[](unsigned long id) { return _chunks[id >> NODE_ARENA_CHUNK_BITS][id & NODE_ARENA_CHUNK_MASK]; }
+        const ConfigspaceNode& operator[](unsigned long id) const { return _chunks[id >> NODE_ARENA_CHUNK_BITS][id & NODE_ARENA_CHUNK_MASK]; }
+
+        // checked lookup; throws out_of_range for ids that do not hold a node
+        ConfigspaceNode& at(unsigned long id);
+        const ConfigspaceNode& at(unsigned long id) const;
+
+        // stores the node in the slot given by its id, replacing any node already there
+        ConfigspaceNode& insert(const ConfigspaceNode& node);
+        void erase(unsigned long id);
+        void clear();
+        bool contains(unsigned long id) const;
+        bool empty() const;
+        unsigned long size() const;
+
+        // one past the highest id the arena has room for without allocating
+        unsigned long capacity() const;
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, _occupied.size()); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, _occupied.size()); }
+};
+
+#endif //NODE_ARENA_H
\ No newline at end of file
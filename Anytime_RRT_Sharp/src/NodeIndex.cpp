@@ -0,0 +1,22 @@
+#include "NodeIndex.hpp"
+#include "KdTree.hpp"
+#include "NodePositionStore.hpp"
+#include "SpatialHashGrid.hpp"
+
+NodeIndex* NodeIndex::create(NodeIndexType type)
+{
+    if (type == SpatialHashIndex)
+        return new SpatialHashGrid();
+    if (type == PositionStoreIndex)
+        return new NodePositionStore();
+    return new KdTree();
+}
+
+vector<unsigned long> NodeIndex::findAllNearest(const vector<Point>& points) const
+{
+    vector<unsigned long> ids;
+    ids.reserve(points.size());
+    for (auto& p : points)
+        ids.push_back(findNearest(p));
+    return ids;
+}
\ No newline at end of file
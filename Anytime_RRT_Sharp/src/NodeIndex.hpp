@@ -0,0 +1,58 @@
+#include <vector>
+#include "Geometry2D.hpp"
+
+using namespace std;
+
+#ifndef NODE_INDEX_H
+#define NODE_INDEX_H
+
+enum NodeIndexType
+{
+    KdTreeIndex,
+    SpatialHashIndex,
+    PositionStoreIndex
+};
+
+// approximate queries counted by an index; a sample of them is audited against an exact
+// search and the inexact count is how many of the audited answers were not exact
+struct ApproximateQueryStats
+{
+    unsigned long queries, audited, inexact;
+};
+
+// spatial index over configspace node positions; implementations must keep
+// const queries free of side effects so they can be shared between readers
+class NodeIndex
+{
+    public:
+        virtual ~NodeIndex() {}
+        virtual NodeIndex* clone() const = 0;
+        virtual void insert(unsigned long id, const Point& p) = 0;
+        virtual void remove(unsigned long id) = 0;
+        virtual void update(unsigned long id, const Point& p) = 0;
+        virtual void clear() = 0;
+        virtual bool contains(unsigned long id) const = 0;
+        virtual unsigned long size() const = 0;
+
+        // returns the id of the closest node to the given point; 0 if the index is empty
+        virtual unsigned long findNearest(const Point& p) const = 0;
+
+        // returns the ids of the (up to) k closest nodes strictly within the radius, sorted by increasing distance
+        virtual vector<unsigned long> findNearest(const Point& p, int k, double radius) const = 0;
+
+        // returns the closest node id for every point; indices that can share work between
+        // queries override this, the default answers them one at a time
+        virtual vector<unsigned long> findAllNearest(const vector<Point>& points) const;
+
+        // hint for the radius of upcoming neighbor queries; indices may reorganize themselves around it
+        virtual void setQueryRadius(double /*radius*/) {}
+
+        // allow answers up to (1 + epsilon) times farther than the exact ones; 0 is exact.
+        // indices without an approximate search ignore this and always answer exactly
+        virtual void setApproximationError(double /*epsilon*/) {}
+        virtual ApproximateQueryStats approximateQueryStats() const { return { 0, 0, 0 }; }
+
+        static NodeIndex* create(NodeIndexType type);
+};
+
+#endif //NODE_INDEX_H
\ No newline at end of file
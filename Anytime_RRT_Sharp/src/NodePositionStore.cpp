@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <math.h>
+#include "NodePositionStore.hpp"
+
+NodePositionStore::NodePositionStore()
+{
+    _buildNodePositionStore();
+}
+
+NodeIndex* NodePositionStore::clone() const
+{
+    return new NodePositionStore(*this);
+}
+
+void NodePositionStore::_buildNodePositionStore()
+{
+    _xs.clear();
+    _ys.clear();
+    _zs.clear();
+    _ids.clear();
+    _idToSlot.clear();
+}
+
+void NodePositionStore::insert(unsigned long id, const Point& p)
+{
+    if (contains(id))
+    {
+        update(id, p);
+        return;
+    }
+
+    if (id >= _idToSlot.size())
+        _idToSlot.resize(max((unsigned long)id + 1, (unsigned long)_idToSlot.size() * 2), NODE_POSITION_STORE_NULL_SLOT);
+
+    _idToSlot[id] = _ids.size();
+    _xs.push_back(p.x());
+    _ys.push_back(p.y());
+    _zs.push_back(p.z());
+    _ids.push_back(id);
+}
+
+void NodePositionStore::remove(unsigned long id)
+{
+    if (!contains(id))
+        return;
+
+    // keep the arrays dense by moving the last entry into the freed slot
+    long slot = _idToSlot[id];
+    long last = _ids.size() - 1;
+
+    _xs[slot] = _xs[last];
+    _ys[slot] = _ys[last];
+    _zs[slot] = _zs[last];
+    _ids[slot] = _ids[last];
+    _idToSlot[_ids[slot]] = slot;
+
+    _xs.pop_back();
+    _ys.pop_back();
+    _zs.pop_back();
+    _ids.pop_back();
+    _idToSlot[id] = NODE_POSITION_STORE_NULL_SLOT;
+}
+
+void NodePositionStore::update(unsigned long id, const Point& p)
+{
+    if (!contains(id))
+    {
+        insert(id, p);
+        return;
+    }
+
+    long slot = _idToSlot[id];
+    _xs[slot] = p.x();
+    _ys[slot] = p.y();
+    _zs[slot] = p.z();
+}
+
+void NodePositionStore::clear()
+{
+    _buildNodePositionStore();
+}
+
+bool NodePositionStore::contains(unsigned long id) const
+{
+    return id < _idToSlot.size() && _idToSlot[id] != NODE_POSITION_STORE_NULL_SLOT;
+}
+
+unsigned long NodePositionStore::size() const { return _ids.size(); }
+
+unsigned long NodePositionStore::findNearest(const Point& p) const
+{
+    double point[3] = { p.x(), p.y(), p.z() };
+    double bestDistSq;
+    unsigned long slot = DistanceKernels::nearestIndex(_xs.data(), _ys.data(), _zs.data(), _ids.size(), point, bestDistSq);
+    return slot < _ids.size() ? _ids[slot] : 0;
+}
+
+vector<unsigned long> NodePositionStore::findNearest(const Point& p, int k, double radius) const
+{
+    vector<unsigned long> ids;
+    if (k <= 0 || radius <= 0)
+        return ids;
+
+    double point[3] = { p.x(), p.y(), p.z() };
+    double maxDistSq = radius * radius;
+    double distSq[NODE_POSITION_STORE_BLOCK_SIZE];
+    vector<pair<double, unsigned long>> heap;
+    heap.reserve(k);
+
+    // compute distances a block at a time into a stack buffer, then feed the bounded heap
+    unsigned long n = _ids.size();
+    for (unsigned long begin = 0; begin < n; begin += NODE_POSITION_STORE_BLOCK_SIZE)
+    {
+        unsigned long count = min((unsigned long)NODE_POSITION_STORE_BLOCK_SIZE, n - begin);
+        DistanceKernels::squaredDistances(_xs.data() + begin, _ys.data() + begin, _zs.data() + begin, count, point, distSq);
+
+        for (unsigned long i = 0; i < count; ++i)
+        {
+            double boundSq = heap.size() < (size_t)k ? maxDistSq : heap.front().first;
+            if (distSq[i] < boundSq)
+            {
+                if (heap.size() == (size_t)k)
+                {
+                    pop_heap(heap.begin(), heap.end());
+                    heap.pop_back();
+                }
+                heap.push_back({ distSq[i], _ids[begin + i] });
+                push_heap(heap.begin(), heap.end());
+            }
+        }
+    }
+
+    sort_heap(heap.begin(), heap.end());
+    ids.reserve(heap.size());
+    for (auto& entry : heap)
+        ids.push_back(entry.second);
+
+    return ids;
+}
+
+vector<unsigned long> NodePositionStore::findAllNearest(const vector<Point>& points) const
+{
+    unsigned long n = _ids.size();
+    vector<unsigned long> bestSlots(points.size(), n);
+    vector<double> bestDistSq(points.size(), INFINITY);
+
+    // blocks are visited in increasing slot order and only strictly closer blocks replace the
+    // best slot, so ties resolve to the lowest slot exactly as in the single query
+    for (unsigned long begin = 0; begin < n; begin += NODE_POSITION_STORE_BATCH_BLOCK_SIZE)
+    {
+        unsigned long count = min((unsigned long)NODE_POSITION_STORE_BATCH_BLOCK_SIZE, n - begin);
+        for (size_t q = 0; q < points.size(); ++q)
+        {
+            double point[3] = { points[q].x(), points[q].y(), points[q].z() };
+            double distSq;
+            unsigned long slot = DistanceKernels::nearestIndex(_xs.data() + begin, _ys.data() + begin, _zs.data() + begin, count, point, distSq);
+            if (slot < count && distSq < bestDistSq[q])
+            {
+                bestDistSq[q] = distSq;
+                bestSlots[q] = begin + slot;
+            }
+        }
+    }
+
+    vector<unsigned long> ids;
+    ids.reserve(points.size());
+    for (unsigned long slot : bestSlots)
+        ids.push_back(slot < n ? _ids[slot] : 0);
+    return ids;
+}
\ No newline at end of file
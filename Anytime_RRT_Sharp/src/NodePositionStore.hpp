@@ -0,0 +1,42 @@
+#include <vector>
+#include "DistanceKernels.hpp"
+#include "Geometry2D.hpp"
+#include "NodeIndex.hpp"
+
+using namespace std;
+
+#ifndef NODE_POSITION_STORE_H
+#define NODE_POSITION_STORE_H
+
+#define NODE_POSITION_STORE_NULL_SLOT -1
+#define NODE_POSITION_STORE_BLOCK_SIZE 256
+#define NODE_POSITION_STORE_BATCH_BLOCK_SIZE 2048   // nodes kept hot in cache while a whole query batch scans them
+
+// contiguous structure-of-arrays mirror of the node positions; queries are brute-force
+// scans using the widest DistanceKernels kernel the cpu supports, which beats a tree
+// for small and medium node counts since there is no pointer chasing
+class NodePositionStore : public NodeIndex
+{
+    vector<double> _xs, _ys, _zs;
+    vector<unsigned long> _ids;
+    vector<long> _idToSlot;
+
+    void _buildNodePositionStore();
+
+    public:
+        NodePositionStore();
+        NodeIndex* clone() const;
+        void insert(unsigned long id, const Point& p);
+        void remove(unsigned long id);
+        void update(unsigned long id, const Point& p);
+        void clear();
+        bool contains(unsigned long id) const;
+        unsigned long size() const;
+        unsigned long findNearest(const Point& p) const;
+        vector<unsigned long> findNearest(const Point& p, int k, double radius) const;
+
+        // scans the store once per block instead of once per query
+        vector<unsigned long> findAllNearest(const vector<Point>& points) const;
+};
+
+#endif //NODE_POSITION_STORE_H
\ No newline at end of file
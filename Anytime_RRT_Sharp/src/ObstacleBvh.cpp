@@ -0,0 +1,253 @@
+#include <algorithm>
+#include "ObstacleBvh.hpp"
+
+ObstacleBvh::ObstacleBvh()
+{
+    _buildObstacleBvh();
+}
+
+ObstacleBvh::ObstacleBvh(const vector<Shape3d*>& obstacles)
+{
+    _buildObstacleBvh();
+    build(obstacles);
+}
+
+void ObstacleBvh::_buildObstacleBvh()
+{
+    _nodes.clear();
+    _obstacles.clear();
+    _depth = 0;
+}
+
+int ObstacleBvh::_buildNode(vector<ObstacleBounds>& bounds, int first, int count, int depth)
+{
+    int index = _nodes.size();
+    _nodes.push_back(BvhNode());
+    _depth = max(_depth, depth + 1);
+
+    BvhNode node;
+    double centerMin[3], centerMax[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        node.min[i] = centerMin[i] = INFINITY;
+        node.max[i] = centerMax[i] = -INFINITY;
+    }
+
+    for (int j = first; j < first + count; ++j)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            node.min[i] = min(node.min[i], bounds[j].min[i]);
+            node.max[i] = max(node.max[i], bounds[j].max[i]);
+            centerMin[i] = min(centerMin[i], bounds[j].center[i]);
+            centerMax[i] = max(centerMax[i], bounds[j].center[i]);
+        }
+    }
+
+    if (count <= OBSTACLE_BVH_LEAF_SIZE)
+    {
+        node.right = 0;
+        node.first = first;
+        node.count = count;
+        _nodes[index] = node;
+        return index;
+    }
+
+    // split at the median center along the axis the centers spread furthest over
+    int axis = 0;
+    for (int i = 1; i < 3; ++i)
+        if (centerMax[i] - centerMin[i] > centerMax[axis] - centerMin[axis])
+            axis = i;
+
+    int half = count / 2;
+    nth_element(bounds.begin() + first, bounds.begin() + first + half, bounds.begin() + first + count,
+        [axis](const ObstacleBounds& b1, const ObstacleBounds& b2) { return b1.center[axis] < b2.center[axis]; });
+
+    _buildNode(bounds, first, half, depth + 1);
+    node.right = _buildNode(bounds, first + half, count - half, depth + 1);
+    node.first = 0;
+    node.count = 0;
+    _nodes[index] = node;
+    return index;
+}
+
+bool ObstacleBvh::_nodeContains(const BvhNode& node, const Point& p) const
+{
+    return p.x() >= node.min[0] && p.x() <= node.max[0] &&
+        p.y() >= node.min[1] && p.y() <= node.max[1] &&
+        p.z() >= node.min[2] && p.z() <= node.max[2];
+}
+
+bool ObstacleBvh::_nodeIntersectsCapsule(const BvhNode& node, const Line& axis, double radius) const
+{
+    // slab test against the node bounds grown by the radius
+    Point p1 = axis.p1(), p2 = axis.p2();
+    double origin[3] = { p1.x(), p1.y(), p1.z() };
+    double delta[3] = { p2.x() - p1.x(), p2.y() - p1.y(), p2.z() - p1.z() };
+    double tMin = 0, tMax = 1;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        double lower = node.min[i] - radius, upper = node.max[i] + radius;
+        if (delta[i] == 0)
+        {
+            if (origin[i] < lower || origin[i] > upper)
+                return false;
+            continue;
+        }
+
+        double t1 = (lower - origin[i]) / delta[i];
+        double t2 = (upper - origin[i]) / delta[i];
+        tMin = max(tMin, min(t1, t2));
+        tMax = min(tMax, max(t1, t2));
+        if (tMin > tMax)
+            return false;
+    }
+
+    return true;
+}
+
+double ObstacleBvh::_nodeDistance(const BvhNode& node, const Point& p) const
+{
+    // zero inside the bounds, so a node never looks further away than its obstacles
+    double coords[3] = { p.x(), p.y(), p.z() };
+    double distanceSq = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        double d = max({ node.min[i] - coords[i], coords[i] - node.max[i], 0.0 });
+        distanceSq += d * d;
+    }
+    return sqrt(distanceSq);
+}
+
+template <class NodeTest, class ObstacleTest>
+bool ObstacleBvh::_anyIntersection(NodeTest nodeTest, ObstacleTest obstacleTest) const
+{
+    if (_nodes.empty())
+        return false;
+
+    int stack[OBSTACLE_BVH_MAX_DEPTH + 1];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const BvhNode& node = _nodes[stack[--stackSize]];
+        if (!nodeTest(node))
+            continue;
+
+        if (node.count > 0)
+        {
+            for (int i = node.first; i < node.first + node.count; ++i)
+                if (obstacleTest(_obstacles[i]))
+                    return true;
+            continue;
+        }
+
+        // a node's first child directly follows it
+        stack[stackSize++] = node.right;
+        stack[stackSize++] = &node - _nodes.data() + 1;
+    }
+
+    return false;
+}
+
+void ObstacleBvh::build(const vector<Shape3d*>& obstacles)
+{
+    _buildObstacleBvh();
+    if (obstacles.empty())
+        return;
+
+    vector<ObstacleBounds> bounds(obstacles.size());
+    for (size_t j = 0; j < obstacles.size(); ++j)
+    {
+        Point minBound = obstacles[j]->minBound(), maxBound = obstacles[j]->maxBound();
+        double minCoords[3] = { minBound.x(), minBound.y(), minBound.z() };
+        double maxCoords[3] = { maxBound.x(), maxBound.y(), maxBound.z() };
+        for (int i = 0; i < 3; ++i)
+        {
+            bounds[j].min[i] = minCoords[i];
+            bounds[j].max[i] = maxCoords[i];
+
+            // unbounded shapes are split as if they sat at the origin
+            double center = 0.5 * (minCoords[i] + maxCoords[i]);
+            bounds[j].center[i] = isfinite(center) ? center : 0;
+        }
+        bounds[j].obstacle = obstacles[j];
+    }
+
+    _nodes.reserve(2 * obstacles.size() / OBSTACLE_BVH_LEAF_SIZE + 1);
+    _buildNode(bounds, 0, bounds.size(), 0);
+
+    _obstacles.resize(bounds.size());
+    for (size_t j = 0; j < bounds.size(); ++j)
+        _obstacles[j] = bounds[j].obstacle;
+}
+
+void ObstacleBvh::clear()
+{
+    _buildObstacleBvh();
+}
+
+unsigned long ObstacleBvh::size() const { return _obstacles.size(); }
+
+const vector<Shape3d*>& ObstacleBvh::obstacles() const { return _obstacles; }
+
+int ObstacleBvh::depth() const { return _depth; }
+
+bool ObstacleBvh::intersects(const Point& p) const
+{
+    return _anyIntersection(
+        [&](const BvhNode& node) { return _nodeContains(node, p); },
+        [&](const Shape3d* obstacle) { return obstacle->intersects(p); });
+}
+
+bool ObstacleBvh::intersects(const Line& segment) const
+{
+    return _anyIntersection(
+        [&](const BvhNode& node) { return _nodeIntersectsCapsule(node, segment, 0); },
+        [&](const Shape3d* obstacle) { return obstacle->intersects(segment); });
+}
+
+bool ObstacleBvh::intersectsCapsule(const Line& axis, double radius) const
+{
+    return _anyIntersection(
+        [&](const BvhNode& node) { return _nodeIntersectsCapsule(node, axis, radius); },
+        [&](const Shape3d* obstacle) { return obstacle->intersectsCapsule(axis, radius); });
+}
+
+double ObstacleBvh::signedDistance(const Point& p) const
+{
+    if (_nodes.empty())
+        return INFINITY;
+
+    // branch and bound: a node is skipped once its bounds are further away than the best
+    // distance found so far, and the nearer child is visited first
+    double best = INFINITY;
+    int stack[OBSTACLE_BVH_MAX_DEPTH + 1];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        int index = stack[--stackSize];
+        const BvhNode& node = _nodes[index];
+        if (_nodeDistance(node, p) >= best)
+            continue;
+
+        if (node.count > 0)
+        {
+            for (int i = node.first; i < node.first + node.count; ++i)
+                best = min(best, _obstacles[i]->signedDistance(p));
+            continue;
+        }
+
+        int first = index + 1, second = node.right;
+        if (_nodeDistance(_nodes[first], p) > _nodeDistance(_nodes[second], p))
+            swap(first, second);
+        stack[stackSize++] = second;
+        stack[stackSize++] = first;
+    }
+
+    return best;
+}
\ No newline at end of file
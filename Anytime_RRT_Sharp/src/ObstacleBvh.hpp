@@ -0,0 +1,62 @@
+#include <math.h>
+#include <vector>
+#include "Geometry2D.hpp"
+#include "Geometry3D.hpp"
+
+using namespace std;
+
+#ifndef OBSTACLE_BVH_H
+#define OBSTACLE_BVH_H
+
+#define OBSTACLE_BVH_LEAF_SIZE 4
+#define OBSTACLE_BVH_MAX_DEPTH 64       // median splits keep the depth near log2(n / OBSTACLE_BVH_LEAF_SIZE)
+
+// static bounding volume hierarchy over obstacle bounds; nodes are stored contiguously in
+// depth-first order and every leaf owns a contiguous range of the reordered obstacles
+class ObstacleBvh
+{
+    struct BvhNode
+    {
+        double min[3], max[3];
+        int right;              // second child; the first child directly follows its parent
+        int first, count;       // obstacle range of a leaf; count is 0 for inner nodes
+    };
+
+    struct ObstacleBounds
+    {
+        double min[3], max[3], center[3];
+        Shape3d* obstacle;
+    };
+
+    vector<BvhNode> _nodes;
+    vector<Shape3d*> _obstacles;
+    int _depth;
+
+    void _buildObstacleBvh();
+    int _buildNode(vector<ObstacleBounds>& bounds, int first, int count, int depth);
+    bool _nodeContains(const BvhNode& node, const Point& p) const;
+    bool _nodeIntersectsCapsule(const BvhNode& node, const Line& axis, double radius) const;
+    double _nodeDistance(const BvhNode& node, const Point& p) const;
+    template <class NodeTest, class ObstacleTest>
+    bool _anyIntersection(NodeTest nodeTest, ObstacleTest obstacleTest) const;
+
+    public:
+        ObstacleBvh();
+        ObstacleBvh(const vector<Shape3d*>& obstacles);
+        void build(const vector<Shape3d*>& obstacles);
+        void clear();
+        unsigned long size() const;
+        int depth() const;
+        const vector<Shape3d*>& obstacles() const;      // in leaf order
+
+        // true if any obstacle intersects the point, segment or capsule; only obstacles whose
+        // bounds the query reaches are tested
+        bool intersects(const Point& p) const;
+        bool intersects(const Line& segment) const;
+        bool intersectsCapsule(const Line& axis, double radius) const;
+
+        // smallest signed distance from the point to any obstacle; INFINITY without obstacles
+        double signedDistance(const Point& p) const;
+};
+
+#endif //OBSTACLE_BVH_H
\ No newline at end of file
@@ -0,0 +1,392 @@
+#include <math.h>
+#include "ObstacleStore.hpp"
+
+#ifdef DISTANCE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+// same rounding rules as DistanceKernels: no fused multiply-adds, so every kernel computes
+// distances exactly like Point::distanceTo
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+struct SphereArrays
+{
+    const double *xs, *ys, *zs, *radii;
+    unsigned long n;
+};
+
+struct BoxArrays
+{
+    const double *minXs, *minYs, *minZs, *maxXs, *maxYs, *maxZs;
+    unsigned long n;
+};
+
+// kernels for one point against all obstacles of a type, and for the first of a block of
+// points any obstacle of a type contains; centers are subtracted from as in Sphere::intersects
+struct ObstacleKernels
+{
+    bool (*spheresContain)(const SphereArrays& spheres, const double* point);
+    bool (*boxesContain)(const BoxArrays& boxes, const double* point);
+    unsigned long (*firstInSpheres)(const SphereArrays& spheres, const double* xs, const double* ys, const double* zs, unsigned long n);
+    unsigned long (*firstInBoxes)(const BoxArrays& boxes, const double* xs, const double* ys, const double* zs, unsigned long n);
+};
+
+static bool spheresContainScalar(const SphereArrays& spheres, const double* point)
+{
+    for (unsigned long i = 0; i < spheres.n; ++i)
+    {
+        double dx = spheres.xs[i] - point[0];
+        double dy = spheres.ys[i] - point[1];
+        double dz = spheres.zs[i] - point[2];
+        if (sqrt(dx * dx + dy * dy + dz * dz) <= spheres.radii[i])
+            return true;
+    }
+    return false;
+}
+
+static bool boxesContainScalar(const BoxArrays& boxes, const double* point)
+{
+    for (unsigned long i = 0; i < boxes.n; ++i)
+        if (point[0] >= boxes.minXs[i] && point[0] <= boxes.maxXs[i] &&
+            point[1] >= boxes.minYs[i] && point[1] <= boxes.maxYs[i] &&
+            point[2] >= boxes.minZs[i] && point[2] <= boxes.maxZs[i])
+            return true;
+    return false;
+}
+
+static unsigned long firstInSpheresScalar(const SphereArrays& spheres, const double* xs, const double* ys, const double* zs, unsigned long n)
+{
+    for (unsigned long i = 0; i < n; ++i)
+    {
+        double point[3] = { xs[i], ys[i], zs[i] };
+        if (spheresContainScalar(spheres, point))
+            return i;
+    }
+    return n;
+}
+
+static unsigned long firstInBoxesScalar(const BoxArrays& boxes, const double* xs, const double* ys, const double* zs, unsigned long n)
+{
+    for (unsigned long i = 0; i < n; ++i)
+    {
+        double point[3] = { xs[i], ys[i], zs[i] };
+        if (boxesContainScalar(boxes, point))
+            return i;
+    }
+    return n;
+}
+
+#ifdef DISTANCE_KERNELS_X86
+
+// point kernels put one obstacle in each lane; block kernels put one point in each lane and
+// broadcast the obstacles, so a block stops early once every lane has been hit
+
+__attribute__((target("avx2")))
+static bool spheresContainAvx2(const SphereArrays& spheres, const double* point)
+{
+    __m256d px = _mm256_set1_pd(point[0]);
+    __m256d py = _mm256_set1_pd(point[1]);
+    __m256d pz = _mm256_set1_pd(point[2]);
+
+    unsigned long i = 0;
+    for (; i + 4 <= spheres.n; i += 4)
+    {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(spheres.xs + i), px);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(spheres.ys + i), py);
+        __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(spheres.zs + i), pz);
+        __m256d dist = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz)));
+        if (_mm256_movemask_pd(_mm256_cmp_pd(dist, _mm256_loadu_pd(spheres.radii + i), _CMP_LE_OQ)))
+            return true;
+    }
+
+    SphereArrays tail = { spheres.xs + i, spheres.ys + i, spheres.zs + i, spheres.radii + i, spheres.n - i };
+    return spheresContainScalar(tail, point);
+}
+
+__attribute__((target("avx2")))
+static bool boxesContainAvx2(const BoxArrays& boxes, const double* point)
+{
+    __m256d px = _mm256_set1_pd(point[0]);
+    __m256d py = _mm256_set1_pd(point[1]);
+    __m256d pz = _mm256_set1_pd(point[2]);
+
+    unsigned long i = 0;
+    for (; i + 4 <= boxes.n; i += 4)
+    {
+        __m256d inside = _mm256_and_pd(_mm256_cmp_pd(px, _mm256_loadu_pd(boxes.minXs + i), _CMP_GE_OQ), _mm256_cmp_pd(px, _mm256_loadu_pd(boxes.maxXs + i), _CMP_LE_OQ));
+        inside = _mm256_and_pd(inside, _mm256_and_pd(_mm256_cmp_pd(py, _mm256_loadu_pd(boxes.minYs + i), _CMP_GE_OQ), _mm256_cmp_pd(py, _mm256_loadu_pd(boxes.maxYs + i), _CMP_LE_OQ)));
+        inside = _mm256_and_pd(inside, _mm256_and_pd(_mm256_cmp_pd(pz, _mm256_loadu_pd(boxes.minZs + i), _CMP_GE_OQ), _mm256_cmp_pd(pz, _mm256_loadu_pd(boxes.maxZs + i), _CMP_LE_OQ)));
+        if (_mm256_movemask_pd(inside))
+            return true;
+    }
+
+    BoxArrays tail = { boxes.minXs + i, boxes.minYs + i, boxes.minZs + i, boxes.maxXs + i, boxes.maxYs + i, boxes.maxZs + i, boxes.n - i };
+    return boxesContainScalar(tail, point);
+}
+
+__attribute__((target("avx2")))
+static unsigned long firstInSpheresAvx2(const SphereArrays& spheres, const double* xs, const double* ys, const double* zs, unsigned long n)
+{
+    unsigned long i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d px = _mm256_loadu_pd(xs + i);
+        __m256d py = _mm256_loadu_pd(ys + i);
+        __m256d pz = _mm256_loadu_pd(zs + i);
+        int hits = 0;
+
+        for (unsigned long j = 0; j < spheres.n && hits != 0xF; ++j)
+        {
+            __m256d dx = _mm256_sub_pd(_mm256_set1_pd(spheres.xs[j]), px);
+            __m256d dy = _mm256_sub_pd(_mm256_set1_pd(spheres.ys[j]), py);
+            __m256d dz = _mm256_sub_pd(_mm256_set1_pd(spheres.zs[j]), pz);
+            __m256d dist = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz)));
+            hits |= _mm256_movemask_pd(_mm256_cmp_pd(dist, _mm256_set1_pd(spheres.radii[j]), _CMP_LE_OQ));
+        }
+
+        if (hits)
+            return i + __builtin_ctz(hits);
+    }
+
+    return i + firstInSpheresScalar(spheres, xs + i, ys + i, zs + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static unsigned long firstInBoxesAvx2(const BoxArrays& boxes, const double* xs, const double* ys, const double* zs, unsigned long n)
+{
+    unsigned long i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d px = _mm256_loadu_pd(xs + i);
+        __m256d py = _mm256_loadu_pd(ys + i);
+        __m256d pz = _mm256_loadu_pd(zs + i);
+        int hits = 0;
+
+        for (unsigned long j = 0; j < boxes.n && hits != 0xF; ++j)
+        {
+            __m256d inside = _mm256_and_pd(_mm256_cmp_pd(px, _mm256_set1_pd(boxes.minXs[j]), _CMP_GE_OQ), _mm256_cmp_pd(px, _mm256_set1_pd(boxes.maxXs[j]), _CMP_LE_OQ));
+            inside = _mm256_and_pd(inside, _mm256_and_pd(_mm256_cmp_pd(py, _mm256_set1_pd(boxes.minYs[j]), _CMP_GE_OQ), _mm256_cmp_pd(py, _mm256_set1_pd(boxes.maxYs[j]), _CMP_LE_OQ)));
+            inside = _mm256_and_pd(inside, _mm256_and_pd(_mm256_cmp_pd(pz, _mm256_set1_pd(boxes.minZs[j]), _CMP_GE_OQ), _mm256_cmp_pd(pz, _mm256_set1_pd(boxes.maxZs[j]), _CMP_LE_OQ)));
+            hits |= _mm256_movemask_pd(inside);
+        }
+
+        if (hits)
+            return i + __builtin_ctz(hits);
+    }
+
+    return i + firstInBoxesScalar(boxes, xs + i, ys + i, zs + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+static bool spheresContainAvx512(const SphereArrays& spheres, const double* point)
+{
+    __m512d px = _mm512_set1_pd(point[0]);
+    __m512d py = _mm512_set1_pd(point[1]);
+    __m512d pz = _mm512_set1_pd(point[2]);
+
+    unsigned long i = 0;
+    for (; i + 8 <= spheres.n; i += 8)
+    {
+        __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(spheres.xs + i), px);
+        __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(spheres.ys + i), py);
+        __m512d dz = _mm512_sub_pd(_mm512_loadu_pd(spheres.zs + i), pz);
+        __m512d dist = _mm512_sqrt_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy)), _mm512_mul_pd(dz, dz)));
+        if (_mm512_cmp_pd_mask(dist, _mm512_loadu_pd(spheres.radii + i), _CMP_LE_OQ))
+            return true;
+    }
+
+    SphereArrays tail = { spheres.xs + i, spheres.ys + i, spheres.zs + i, spheres.radii + i, spheres.n - i };
+    return spheresContainScalar(tail, point);
+}
+
+__attribute__((target("avx512f")))
+static bool boxesContainAvx512(const BoxArrays& boxes, const double* point)
+{
+    __m512d px = _mm512_set1_pd(point[0]);
+    __m512d py = _mm512_set1_pd(point[1]);
+    __m512d pz = _mm512_set1_pd(point[2]);
+
+    unsigned long i = 0;
+    for (; i + 8 <= boxes.n; i += 8)
+    {
+        __mmask8 inside = _mm512_cmp_pd_mask(px, _mm512_loadu_pd(boxes.minXs + i), _CMP_GE_OQ);
+        inside = _mm512_mask_cmp_pd_mask(inside, px, _mm512_loadu_pd(boxes.maxXs + i), _CMP_LE_OQ);
+        inside = _mm512_mask_cmp_pd_mask(inside, py, _mm512_loadu_pd(boxes.minYs + i), _CMP_GE_OQ);
+        inside = _mm512_mask_cmp_pd_mask(inside, py, _mm512_loadu_pd(boxes.maxYs + i), _CMP_LE_OQ);
+        inside = _mm512_mask_cmp_pd_mask(inside, pz, _mm512_loadu_pd(boxes.minZs + i), _CMP_GE_OQ);
+        inside = _mm512_mask_cmp_pd_mask(inside, pz, _mm512_loadu_pd(boxes.maxZs + i), _CMP_LE_OQ);
+        if (inside)
+            return true;
+    }
+
+    BoxArrays tail = { boxes.minXs + i, boxes.minYs + i, boxes.minZs + i, boxes.maxXs + i, boxes.maxYs + i, boxes.maxZs + i, boxes.n - i };
+    return boxesContainScalar(tail, point);
+}
+
+__attribute__((target("avx512f")))
+static unsigned long firstInSpheresAvx512(const SphereArrays& spheres, const double* xs, const double* ys, const double* zs, unsigned long n)
+{
+    unsigned long i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m512d px = _mm512_loadu_pd(xs + i);
+        __m512d py = _mm512_loadu_pd(ys + i);
+        __m512d pz = _mm512_loadu_pd(zs + i);
+        __mmask8 hits = 0;
+
+        for (unsigned long j = 0; j < spheres.n && hits != 0xFF; ++j)
+        {
+            __m512d dx = _mm512_sub_pd(_mm512_set1_pd(spheres.xs[j]), px);
+            __m512d dy = _mm512_sub_pd(_mm512_set1_pd(spheres.ys[j]), py);
+            __m512d dz = _mm512_sub_pd(_mm512_set1_pd(spheres.zs[j]), pz);
+            __m512d dist = _mm512_sqrt_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy)), _mm512_mul_pd(dz, dz)));
+            hits |= _mm512_cmp_pd_mask(dist, _mm512_set1_pd(spheres.radii[j]), _CMP_LE_OQ);
+        }
+
+        if (hits)
+            return i + __builtin_ctz(hits);
+    }
+
+    return i + firstInSpheresScalar(spheres, xs + i, ys + i, zs + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+static unsigned long firstInBoxesAvx512(const BoxArrays& boxes, const double* xs, const double* ys, const double* zs, unsigned long n)
+{
+    unsigned long i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m512d px = _mm512_loadu_pd(xs + i);
+        __m512d py = _mm512_loadu_pd(ys + i);
+        __m512d pz = _mm512_loadu_pd(zs + i);
+        __mmask8 hits = 0;
+
+        for (unsigned long j = 0; j < boxes.n && hits != 0xFF; ++j)
+        {
+            __mmask8 inside = _mm512_cmp_pd_mask(px, _mm512_set1_pd(boxes.minXs[j]), _CMP_GE_OQ);
+            inside = _mm512_mask_cmp_pd_mask(inside, px, _mm512_set1_pd(boxes.maxXs[j]), _CMP_LE_OQ);
+            inside = _mm512_mask_cmp_pd_mask(inside, py, _mm512_set1_pd(boxes.minYs[j]), _CMP_GE_OQ);
+            inside = _mm512_mask_cmp_pd_mask(inside, py, _mm512_set1_pd(boxes.maxYs[j]), _CMP_LE_OQ);
+            inside = _mm512_mask_cmp_pd_mask(inside, pz, _mm512_set1_pd(boxes.minZs[j]), _CMP_GE_OQ);
+            inside = _mm512_mask_cmp_pd_mask(inside, pz, _mm512_set1_pd(boxes.maxZs[j]), _CMP_LE_OQ);
+            hits |= inside;
+        }
+
+        if (hits)
+            return i + __builtin_ctz(hits);
+    }
+
+    return i + firstInBoxesScalar(boxes, xs + i, ys + i, zs + i, n - i);
+}
+
+#endif //DISTANCE_KERNELS_X86
+
+static const ObstacleKernels& obstacleKernels()
+{
+    static const ObstacleKernels scalar = { spheresContainScalar, boxesContainScalar, firstInSpheresScalar, firstInBoxesScalar };
+#ifdef DISTANCE_KERNELS_X86
+    static const ObstacleKernels avx2 = { spheresContainAvx2, boxesContainAvx2, firstInSpheresAvx2, firstInBoxesAvx2 };
+    static const ObstacleKernels avx512 = { spheresContainAvx512, boxesContainAvx512, firstInSpheresAvx512, firstInBoxesAvx512 };
+
+    DistanceKernelType type = DistanceKernels::kernelType();
+    if (type == Avx512Kernel)
+        return avx512;
+    if (type == Avx2Kernel)
+        return avx2;
+#endif
+    return scalar;
+}
+
+ObstacleStore::ObstacleStore()
+{
+    _buildObstacleStore();
+}
+
+ObstacleStore::ObstacleStore(const vector<Shape3d*>& obstacles)
+{
+    _buildObstacleStore();
+    build(obstacles);
+}
+
+void ObstacleStore::_buildObstacleStore()
+{
+    for (auto array : { &_sphereXs, &_sphereYs, &_sphereZs, &_sphereRadii, &_boxMinXs, &_boxMinYs, &_boxMinZs, &_boxMaxXs, &_boxMaxYs, &_boxMaxZs })
+        array->clear();
+    _otherShapes.clear();
+}
+
+void ObstacleStore::build(const vector<Shape3d*>& obstacles)
+{
+    _buildObstacleStore();
+
+    for (auto o : obstacles)
+    {
+        if (auto sphere = dynamic_cast<const Sphere*>(o))
+        {
+            _sphereXs.push_back(sphere->x());
+            _sphereYs.push_back(sphere->y());
+            _sphereZs.push_back(sphere->z());
+            _sphereRadii.push_back(sphere->radius());
+        }
+        else if (auto rect = dynamic_cast<const Rectangle*>(o))
+        {
+            _boxMinXs.push_back(rect->minX());
+            _boxMinYs.push_back(rect->minY());
+            _boxMinZs.push_back(rect->minZ());
+            _boxMaxXs.push_back(rect->maxX());
+            _boxMaxYs.push_back(rect->maxY());
+            _boxMaxZs.push_back(rect->maxZ());
+        }
+        else
+            _otherShapes.push_back(o);
+    }
+}
+
+void ObstacleStore::clear()
+{
+    _buildObstacleStore();
+}
+
+unsigned long ObstacleStore::size() const { return numSpheres() + numBoxes() + numOtherShapes(); }
+
+unsigned long ObstacleStore::numSpheres() const { return _sphereRadii.size(); }
+
+unsigned long ObstacleStore::numBoxes() const { return _boxMinXs.size(); }
+
+unsigned long ObstacleStore::numOtherShapes() const { return _otherShapes.size(); }
+
+bool ObstacleStore::intersects(const Point& p) const
+{
+    const ObstacleKernels& kernels = obstacleKernels();
+    double point[3] = { p.x(), p.y(), p.z() };
+    SphereArrays spheres = { _sphereXs.data(), _sphereYs.data(), _sphereZs.data(), _sphereRadii.data(), numSpheres() };
+    BoxArrays boxes = { _boxMinXs.data(), _boxMinYs.data(), _boxMinZs.data(), _boxMaxXs.data(), _boxMaxYs.data(), _boxMaxZs.data(), numBoxes() };
+
+    if (kernels.spheresContain(spheres, point) || kernels.boxesContain(boxes, point))
+        return true;
+
+    for (auto o : _otherShapes)
+        if (o->intersects(p))
+            return true;
+    return false;
+}
+
+unsigned long ObstacleStore::firstIntersecting(const double* xs, const double* ys, const double* zs, unsigned long n) const
+{
+    const ObstacleKernels& kernels = obstacleKernels();
+    SphereArrays spheres = { _sphereXs.data(), _sphereYs.data(), _sphereZs.data(), _sphereRadii.data(), numSpheres() };
+    BoxArrays boxes = { _boxMinXs.data(), _boxMinYs.data(), _boxMinZs.data(), _boxMaxXs.data(), _boxMaxYs.data(), _boxMaxZs.data(), numBoxes() };
+
+    // each type only has to look at the points before the first hit found so far
+    unsigned long first = kernels.firstInSpheres(spheres, xs, ys, zs, n);
+    first = kernels.firstInBoxes(boxes, xs, ys, zs, first);
+    for (unsigned long i = 0; i < first; ++i)
+        for (auto o : _otherShapes)
+            if (o->intersects(Point(xs[i], ys[i], zs[i])))
+                return i;
+    return first;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include <vector>
+#include "DistanceKernels.hpp"
+#include "Geometry2D.hpp"
+#include "Geometry3D.hpp"
+
+using namespace std;
+
+#ifndef OBSTACLE_STORE_H
+#define OBSTACLE_STORE_H
+
+#define OBSTACLE_STORE_SAMPLE_BLOCK_SIZE 64     // path samples gathered per batched kernel call
+
+// obstacles split by type into structure-of-arrays storage so a point, or a block of path
+// samples, is tested against several obstacles per instruction; the kernels follow
+// DistanceKernels::kernelType() and give exactly the answers of Shape3d::intersects(Point).
+// Shapes other than spheres and rectangles are kept as pointers and tested through Shape3d
+class ObstacleStore
+{
+    vector<double> _sphereXs, _sphereYs, _sphereZs, _sphereRadii;
+    vector<double> _boxMinXs, _boxMinYs, _boxMinZs, _boxMaxXs, _boxMaxYs, _boxMaxZs;
+    vector<Shape3d*> _otherShapes;
+
+    void _buildObstacleStore();
+
+    public:
+        ObstacleStore();
+        ObstacleStore(const vector<Shape3d*>& obstacles);
+        void build(const vector<Shape3d*>& obstacles);
+        void clear();
+        unsigned long size() const;
+        unsigned long numSpheres() const;
+        unsigned long numBoxes() const;
+        unsigned long numOtherShapes() const;
+
+        // true if any obstacle intersects the point
+        bool intersects(const Point& p) const;
+
+        // index of the first of the n points that any obstacle intersects, or n if none does
+        unsigned long firstIntersecting(const double* xs, const double* ys, const double* zs, unsigned long n) const;
+};
+
+#endif //OBSTACLE_STORE_H
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include "PlannerHandle.hpp"
+
+PlannerHandle::PlannerHandle()
+{
+    _cancelled = false;
+    _bestCost = INFINITY;
+    _updates = 0;
+}
+
+void PlannerHandle::cancel() { _cancelled = true; }
+
+bool PlannerHandle::isCancelled() const { return _cancelled; }
+
+void PlannerHandle::setOnImprovedPath(function<void(const vector<State>& path, double cost)> callback)
+{
+    lock_guard<mutex> lock(_mutex);
+    _onImprovedPath = callback;
+}
+
+bool PlannerHandle::hasPath() const { return updates() > 0; }
+
+double PlannerHandle::bestCost() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _bestCost;
+}
+
+vector<State> PlannerHandle::bestPath() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _bestPath;
+}
+
+unsigned long PlannerHandle::updates() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _updates;
+}
+
+void PlannerHandle::publish(const vector<State>& path, double cost)
+{
+    function<void(const vector<State>&, double)> callback;
+    {
+        lock_guard<mutex> lock(_mutex);
+        if (cost >= _bestCost)
+            return;
+        _bestPath = path;
+        _bestCost = cost;
+        ++_updates;
+        callback = _onImprovedPath;
+    }
+
+    // outside the lock so the callback can poll or cancel the handle
+    if (callback)
+        callback(path, cost);
+}
\ No newline at end of file
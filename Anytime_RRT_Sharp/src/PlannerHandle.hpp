@@ -0,0 +1,48 @@
+#include <atomic>
+#include <functional>
+#include <math.h>
+#include <mutex>
+#include <vector>
+#include "cppshrhelp.hpp"
+#include "Geometry2D.hpp"
+
+using namespace std;
+
+#ifndef PLANNER_HANDLE_H
+#define PLANNER_HANDLE_H
+
+// shared between a planning run and the threads watching it. the planner publishes every
+// strictly cheaper path to the goal region as soon as it finds it, and stops at the start of
+// its next iteration once cancelled. use one handle per run
+class DLL_EXPORT PlannerHandle
+{
+    mutable mutex _mutex;
+    atomic<bool> _cancelled;
+    vector<State> _bestPath;
+    double _bestCost;
+    unsigned long _updates;
+    function<void(const vector<State>&, double)> _onImprovedPath;
+
+    public:
+        PlannerHandle();
+
+        // requests the planner to stop; safe to call from any thread, including the callback
+        void cancel();
+        bool isCancelled() const;
+
+        // called on the planning thread with each improved path, goal node first and root last,
+        // and its cost. planning waits for it to return, so it should be quick
+        void setOnImprovedPath(function<void(const vector<State>& path, double cost)> callback);
+
+        // polled access to the last published path; updates counts the published paths, so a
+        // change in it means there is a new path
+        bool hasPath() const;
+        double bestCost() const;
+        vector<State> bestPath() const;
+        unsigned long updates() const;
+
+        // called by the planner; paths that aren't cheaper than the published one are ignored
+        void publish(const vector<State>& path, double cost);
+};
+
+#endif //PLANNER_HANDLE_H
\ No newline at end of file
@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <stdlib.h>
+#include "SpatialHashGrid.hpp"
+
+SpatialHashGrid::SpatialHashGrid()
+{
+    _buildSpatialHashGrid(SPATIAL_HASH_DEFAULT_CELL_SIZE);
+}
+
+SpatialHashGrid::SpatialHashGrid(double cellSize)
+{
+    _buildSpatialHashGrid(cellSize);
+}
+
+NodeIndex* SpatialHashGrid::clone() const
+{
+    return new SpatialHashGrid(*this);
+}
+
+void SpatialHashGrid::_buildSpatialHashGrid(double cellSize)
+{
+    _cellSize = cellSize;
+    _cells.clear();
+    _entries.clear();
+    _size = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        _minCell[i] = 0;
+        _maxCell[i] = -1;
+    }
+}
+
+void SpatialHashGrid::_rebucket(double cellSize)
+{
+    _cellSize = cellSize;
+    _cells.clear();
+    for (int i = 0; i < 3; ++i)
+    {
+        _minCell[i] = 0;
+        _maxCell[i] = -1;
+    }
+
+    for (const GridEntry& entry : _entries)
+        if (entry.id)
+            _insertEntry(entry);
+}
+
+void SpatialHashGrid::_cellCoords(const double* point, long* cell) const
+{
+    for (int i = 0; i < 3; ++i)
+        cell[i] = (long)floor(point[i] / _cellSize);
+}
+
+unsigned long long SpatialHashGrid::_cellKey(long cx, long cy, long cz) const
+{
+    // pack 21 bits per axis; cells further than 2^20 from the origin wrap but stay correct
+    // since every entry in a bucket is still distance checked
+    const unsigned long long mask = (1ULL << 21) - 1;
+    return ((unsigned long long)cx & mask) | (((unsigned long long)cy & mask) << 21) | (((unsigned long long)cz & mask) << 42);
+}
+
+void SpatialHashGrid::_insertEntry(const GridEntry& entry)
+{
+    long cell[3];
+    _cellCoords(entry.point, cell);
+    _cells[_cellKey(cell[0], cell[1], cell[2])].push_back(entry);
+
+    bool empty = _maxCell[0] < _minCell[0];
+    for (int i = 0; i < 3; ++i)
+    {
+        _minCell[i] = empty ? cell[i] : min(_minCell[i], cell[i]);
+        _maxCell[i] = empty ? cell[i] : max(_maxCell[i], cell[i]);
+    }
+}
+
+void SpatialHashGrid::_visitCell(long cx, long cy, long cz, const double* point, int k, double maxDistSq, vector<pair<double, unsigned long>>& heap) const
+{
+    auto cellItr = _cells.find(_cellKey(cx, cy, cz));
+    if (cellItr == _cells.end())
+        return;
+
+    for (const GridEntry& entry : cellItr->second)
+    {
+        double dx = entry.point[0] - point[0];
+        double dy = entry.point[1] - point[1];
+        double dz = entry.point[2] - point[2];
+        double distSq = dx * dx + dy * dy + dz * dz;
+        double boundSq = heap.size() < (size_t)k ? maxDistSq : heap.front().first;
+
+        if (distSq < boundSq)
+        {
+            if (heap.size() == (size_t)k)
+            {
+                pop_heap(heap.begin(), heap.end());
+                heap.pop_back();
+            }
+            heap.push_back({ distSq, entry.id });
+            push_heap(heap.begin(), heap.end());
+        }
+    }
+}
+
+vector<pair<double, unsigned long>> SpatialHashGrid::_scanAll(const double* point, int k, double maxDistSq) const
+{
+    vector<pair<double, unsigned long>> heap;
+    heap.reserve(k);
+
+    for (auto& cell : _cells)
+    {
+        for (const GridEntry& entry : cell.second)
+        {
+            double dx = entry.point[0] - point[0];
+            double dy = entry.point[1] - point[1];
+            double dz = entry.point[2] - point[2];
+            double distSq = dx * dx + dy * dy + dz * dz;
+            double boundSq = heap.size() < (size_t)k ? maxDistSq : heap.front().first;
+
+            if (distSq < boundSq)
+            {
+                if (heap.size() == (size_t)k)
+                {
+                    pop_heap(heap.begin(), heap.end());
+                    heap.pop_back();
+                }
+                heap.push_back({ distSq, entry.id });
+                push_heap(heap.begin(), heap.end());
+            }
+        }
+    }
+    return heap;
+}
+
+void SpatialHashGrid::insert(unsigned long id, const Point& p)
+{
+    if (contains(id))
+        remove(id);
+
+    if (id >= _entries.size())
+        _entries.resize(max((unsigned long)id + 1, (unsigned long)_entries.size() * 2), GridEntry{ { 0, 0, 0 }, 0 });
+
+    GridEntry entry{ { p.x(), p.y(), p.z() }, id };
+    _entries[id] = entry;
+    _insertEntry(entry);
+    ++_size;
+}
+
+void SpatialHashGrid::remove(unsigned long id)
+{
+    if (!contains(id))
+        return;
+
+    long cell[3];
+    _cellCoords(_entries[id].point, cell);
+    auto& bucket = _cells[_cellKey(cell[0], cell[1], cell[2])];
+    for (auto itr = bucket.begin(); itr != bucket.end(); ++itr)
+    {
+        if (itr->id == id)
+        {
+            *itr = bucket.back();
+            bucket.pop_back();
+            break;
+        }
+    }
+
+    _entries[id].id = 0;
+    --_size;
+}
+
+void SpatialHashGrid::update(unsigned long id, const Point& p)
+{
+    if (contains(id))
+    {
+        const GridEntry& entry = _entries[id];
+        if (entry.point[0] == p.x() && entry.point[1] == p.y() && entry.point[2] == p.z())
+            return;
+    }
+    insert(id, p);
+}
+
+void SpatialHashGrid::clear()
+{
+    _buildSpatialHashGrid(_cellSize);
+}
+
+bool SpatialHashGrid::contains(unsigned long id) const
+{
+    return id > 0 && id < _entries.size() && _entries[id].id == id;
+}
+
+unsigned long SpatialHashGrid::size() const { return _size; }
+
+double SpatialHashGrid::cellSize() const { return _cellSize; }
+
+void SpatialHashGrid::setQueryRadius(double radius)
+{
+    if (radius <= 0 || isinf(radius))
+        return;
+
+    if (radius > _cellSize || radius < SPATIAL_HASH_MIN_CELL_FILL * _cellSize)
+        _rebucket(radius);
+}
+
+unsigned long SpatialHashGrid::findNearest(const Point& p) const
+{
+    if (_size == 0)
+        return 0;
+
+    double point[3] = { p.x(), p.y(), p.z() };
+    long cell[3];
+    _cellCoords(point, cell);
+
+    // grow a shell of cells around the query point; anything outside a shell of
+    // radius r cells is at least r * cellSize away, so stop once the best beats that
+    vector<pair<double, unsigned long>> heap;
+    long maxRing = 0;
+    for (int i = 0; i < 3; ++i)
+        maxRing = max(maxRing, max(abs(cell[i] - _minCell[i]), abs(_maxCell[i] - cell[i])));
+
+    double cellsToVisit = pow(2.0 * maxRing + 1.0, 3);
+    if (cellsToVisit > 8.0 * _size)
+    {
+        heap = _scanAll(point, 1, INFINITY);
+        return heap.front().second;
+    }
+
+    heap.reserve(1);
+    for (long ring = 0; ring <= maxRing; ++ring)
+    {
+        for (long dx = -ring; dx <= ring; ++dx)
+        {
+            for (long dy = -ring; dy <= ring; ++dy)
+            {
+                // interior columns of the shell only contribute their two end caps
+                bool onSide = abs(dx) == ring || abs(dy) == ring;
+                long dzStep = onSide || ring == 0 ? 1 : 2 * ring;
+                for (long dz = -ring; dz <= ring; dz += dzStep)
+                    _visitCell(cell[0] + dx, cell[1] + dy, cell[2] + dz, point, 1, INFINITY, heap);
+            }
+        }
+
+        double shellDist = ring * _cellSize;
+        if (!heap.empty() && heap.front().first <= shellDist * shellDist)
+            break;
+    }
+
+    return heap.front().second;
+}
+
+vector<unsigned long> SpatialHashGrid::findNearest(const Point& p, int k, double radius) const
+{
+    vector<unsigned long> ids;
+    if (k <= 0 || radius <= 0 || _size == 0)
+        return ids;
+
+    double point[3] = { p.x(), p.y(), p.z() };
+    long cell[3];
+    _cellCoords(point, cell);
+
+    vector<pair<double, unsigned long>> heap;
+    long reach = (long)ceil(radius / _cellSize);
+
+    if (isinf(radius) || pow(2.0 * reach + 1.0, 3) > 8.0 * _size)
+    {
+        heap = _scanAll(point, k, radius * radius);
+    }
+    else
+    {
+        // with the cell size tracking the query radius, reach is 1 and this visits the 27 adjacent cells
+        heap.reserve(k);
+        for (long dx = -reach; dx <= reach; ++dx)
+            for (long dy = -reach; dy <= reach; ++dy)
+                for (long dz = -reach; dz <= reach; ++dz)
+                    _visitCell(cell[0] + dx, cell[1] + dy, cell[2] + dz, point, k, radius * radius, heap);
+    }
+
+    sort_heap(heap.begin(), heap.end());
+    ids.reserve(heap.size());
+    for (auto& entry : heap)
+        ids.push_back(entry.second);
+
+    return ids;
+}
\ No newline at end of file
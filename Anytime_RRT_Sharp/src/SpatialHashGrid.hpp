@@ -0,0 +1,69 @@
+#include <math.h>
+#include <unordered_map>
+#include <vector>
+#include "Geometry2D.hpp"
+#include "NodeIndex.hpp"
+
+using namespace std;
+
+#ifndef SPATIAL_HASH_GRID_H
+#define SPATIAL_HASH_GRID_H
+
+#define SPATIAL_HASH_DEFAULT_CELL_SIZE 1.0
+#define SPATIAL_HASH_MIN_CELL_FILL 0.5      // rebucket once the query radius falls below this fraction of the cell size
+
+struct cell_key_hash
+{
+    size_t operator()(const unsigned long long& k) const
+    {
+        // splitmix64 finalizer; packed cell coordinates are highly correlated otherwise
+        unsigned long long h = k;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        return h ^ (h >> 31);
+    }
+};
+
+// uniform hashed voxel grid over node positions; the cell size follows the neighbor
+// query radius so a radius query only has to visit the 27 cells around the query point
+class SpatialHashGrid : public NodeIndex
+{
+    struct GridEntry
+    {
+        double point[3];
+        unsigned long id;
+    };
+
+    double _cellSize;
+    unordered_map<unsigned long long, vector<GridEntry>, cell_key_hash> _cells;
+    vector<GridEntry> _entries;     // entry for every id; id 0 marks an empty slot
+    unsigned long _size;
+    long _minCell[3], _maxCell[3];  // bounds of the occupied cells
+
+    void _buildSpatialHashGrid(double cellSize);
+    void _rebucket(double cellSize);
+    void _cellCoords(const double* point, long* cell) const;
+    unsigned long long _cellKey(long cx, long cy, long cz) const;
+    void _insertEntry(const GridEntry& entry);
+    void _visitCell(long cx, long cy, long cz, const double* point, int k, double maxDistSq, vector<pair<double, unsigned long>>& heap) const;
+    vector<pair<double, unsigned long>> _scanAll(const double* point, int k, double maxDistSq) const;
+
+    public:
+        SpatialHashGrid();
+        SpatialHashGrid(double cellSize);
+        NodeIndex* clone() const;
+        void insert(unsigned long id, const Point& p);
+        void remove(unsigned long id);
+        void update(unsigned long id, const Point& p);
+        void clear();
+        bool contains(unsigned long id) const;
+        unsigned long size() const;
+        double cellSize() const;
+        unsigned long findNearest(const Point& p) const;
+        vector<unsigned long> findNearest(const Point& p, int k, double radius) const;
+
+        // rebuckets when the radius exceeds the cell size or shrinks below SPATIAL_HASH_MIN_CELL_FILL of it
+        void setQueryRadius(double radius);
+};
+
+#endif //SPATIAL_HASH_GRID_H
\ No newline at end of file
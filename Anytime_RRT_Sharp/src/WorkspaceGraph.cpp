@@ -1,16 +1,166 @@
 #include "WorkspaceGraph.hpp"
 
+// samples checked by the calling thread; a path's samples are the difference across its check,
+// which stays exact while other threads check paths on the same graph
+static thread_local unsigned long threadSamplesChecked = 0;
+
+WorkspaceGraph::SampleCounters& WorkspaceGraph::SampleCounters::operator=(const SampleCounters& counters)
+{
+    pathsChecked = counters.pathsChecked.load();
+    samplesChecked = counters.samplesChecked.load();
+    boundsChecked = counters.boundsChecked.load();
+    pathsRejected = counters.pathsRejected.load();
+    rejectionSamples = counters.rejectionSamples.load();
+    return *this;
+}
+
 void WorkspaceGraph::_buildWorkspaceGraph()
 {
     _minPoint = Point(0, 0, 0);
     _maxPoint = Point(0, 0, 0);
     _goalRegionReached = false;
+    _sampleOrder = BisectionOrder;
+    resetSampleStats();
+}
+
+bool WorkspaceGraph::_nodeInFreespace(const Point& point) const
+{
+    // the workspace is its own limits; no temporary rectangle with surfaces and corners
+    return point.x() >= _minPoint.x() && point.x() <= _maxPoint.x() &&
+           point.y() >= _minPoint.y() && point.y() <= _maxPoint.y() &&
+           point.z() >= _minPoint.z() && point.z() <= _maxPoint.z();
+}
+
+bool WorkspaceGraph::_sampleIsSafe(const Point& point) const
+{
+    ++threadSamplesChecked;
+    return nodeIsSafe(point) && _nodeInFreespace(point);
 }
 
-bool WorkspaceGraph::_nodeInFreespace(Point& point) const
+// calls visit on the indices 0..n-1 in the given order and stops at the first visit that returns
+// false; the bisection order visits both ends, then the odd multiples of each power-of-two
+// stride from the largest down, so collisions anywhere on a path are found after few samples
+template <typename Visit>
+static bool visitSamples(unsigned long n, SampleOrder order, Visit visit)
 {
-    Rectangle limits(_minPoint, _maxPoint);
-    return limits.intersects(point);
+    if (order == SequentialOrder || n <= 2)
+    {
+        for (unsigned long i = 0; i < n; ++i)
+            if (!visit(i))
+                return false;
+        return true;
+    }
+
+    if (!visit(0) || !visit(n - 1))
+        return false;
+
+    unsigned long stride = 1;
+    while (stride * 2 < n - 1)
+        stride *= 2;
+    for (; stride > 0; stride /= 2)
+        for (unsigned long i = stride; i < n - 1; i += 2 * stride)
+            if (!visit(i))
+                return false;
+    return true;
+}
+
+bool WorkspaceGraph::_samplesAreSafe(const State* samples, unsigned long numSamples) const
+{
+    if (_distanceField)
+        return _tracedSamplesAreSafe(samples, numSamples);
+
+    if (_obstacleStore.size() > OBSTACLE_STORE_MAX_LINEAR_SCAN)
+        return visitSamples(numSamples, _sampleOrder, [&](unsigned long i) { return _sampleIsSafe(samples[i]); });
+
+    // few obstacles: gather blocks of samples in visiting order so the store tests several
+    // samples per instruction and still stops at the first vector with a hit
+    double xs[OBSTACLE_STORE_SAMPLE_BLOCK_SIZE], ys[OBSTACLE_STORE_SAMPLE_BLOCK_SIZE], zs[OBSTACLE_STORE_SAMPLE_BLOCK_SIZE];
+    unsigned long count = 0;
+    auto blockIsSafe = [&]() {
+        unsigned long first = _obstacleStore.firstIntersecting(xs, ys, zs, count);
+        threadSamplesChecked += min(first + 1, count);
+        bool isSafe = first == count;
+        count = 0;
+        return isSafe;
+    };
+
+    bool isSafe = visitSamples(numSamples, _sampleOrder, [&](unsigned long i) {
+        const Point& p = samples[i];
+        if (!_nodeInFreespace(p))
+        {
+            threadSamplesChecked += count + 1;
+            return false;
+        }
+
+        xs[count] = p.x();
+        ys[count] = p.y();
+        zs[count] = p.z();
+        return ++count < OBSTACLE_STORE_SAMPLE_BLOCK_SIZE || blockIsSafe();
+    });
+    return isSafe && (count == 0 || blockIsSafe());
+}
+
+bool WorkspaceGraph::_tracedSamplesAreSafe(const State* samples, unsigned long numSamples) const
+{
+    // a sample closer to a checked sample than its clearance can't touch an obstacle; the
+    // vehicle's bounding radius is taken off the clearance so its whole ball stays clear.
+    // Neighbors are covered outwards until one falls outside the clearance
+    static thread_local vector<char> covered;
+    covered.assign(numSamples, 0);
+    double margin = _vehicle.boundingRadius();
+
+    return visitSamples(numSamples, _sampleOrder, [&](unsigned long i) {
+        const Point& p = samples[i];
+        if (covered[i])
+            return _nodeInFreespace(p);
+        if (!_sampleIsSafe(p))
+            return false;
+
+        double lower, upper;
+        if (!_distanceField->lookup(p, lower, upper) || lower - margin <= 0)
+            return true;
+        for (unsigned long j = i + 1; j < numSamples && samples[j].distanceTo(p) + margin < lower; ++j)
+            covered[j] = 1;
+        for (unsigned long j = i; j > 0 && samples[j - 1].distanceTo(p) + margin < lower; --j)
+            covered[j - 1] = 1;
+        return true;
+    });
+}
+
+bool WorkspaceGraph::_finishPath(bool isSafe, unsigned long samplesBefore) const
+{
+    unsigned long numSamples = threadSamplesChecked - samplesBefore;
+    _counters.samplesChecked.fetch_add(numSamples, memory_order_relaxed);
+    if (!isSafe)
+    {
+        _counters.pathsRejected.fetch_add(1, memory_order_relaxed);
+        _counters.rejectionSamples.fetch_add(numSamples, memory_order_relaxed);
+    }
+    return isSafe;
+}
+
+bool WorkspaceGraph::_traceCapsule(const Point& p1, const Point& p2, double radius) const
+{
+    if (!_distanceField)
+        return false;
+
+    // every axis point closer than (clearance - radius) to a traced point has its whole
+    // cross-section clear, so the trace advances by that much until it passes p2
+    Vector delta = p2 - p1;
+    double length = p1.distanceTo(p2);
+    double minStep = _distanceField->resolution() * DISTANCE_FIELD_MIN_TRACE_STEP;
+    double lower, upper;
+
+    for (double t = 0; ; )
+    {
+        Point p = length > 0 ? p1 + delta * (t / length) : p1;
+        if (!_distanceField->lookup(p, lower, upper) || lower - radius < minStep)
+            return false;
+
+        t += lower - radius;
+        if (t > length)
+            return true;
+    }
 }
 
 void WorkspaceGraph::setGoalRegion(State goalState, double radius)
@@ -28,14 +178,37 @@ void WorkspaceGraph::defineFreespace(Rectangle limits)
 void WorkspaceGraph::addObstacle(double x, double y, double z, double radius)
 {
     _obstacles.push_back(new Sphere(x, y, z, radius));
+    _obstacleBvh.build(_obstacles);
+    _obstacleStore.build(_obstacles);
+    clearDistanceField();
 }
 
 void WorkspaceGraph::addObstacles(vector<Shape3d*>& obstacles)
 {
     for (auto o : obstacles)
         _obstacles.push_back(o);
+    _obstacleBvh.build(_obstacles);
+    _obstacleStore.build(_obstacles);
+    clearDistanceField();
 }
 
+void WorkspaceGraph::buildDistanceField(double resolution, int numThreads)
+{
+    auto field = make_shared<DistanceField>();
+    field->build(*this, _obstacleBvh, resolution, numThreads);
+    _distanceField = field;
+}
+
+void WorkspaceGraph::setDistanceField(DistanceField field) { _distanceField = make_shared<const DistanceField>(move(field)); }
+
+void WorkspaceGraph::clearDistanceField() { _distanceField.reset(); }
+
+bool WorkspaceGraph::hasDistanceField() const { return _distanceField != nullptr; }
+
+const DistanceField& WorkspaceGraph::distanceField() const { return *_distanceField; }
+
+uint64_t WorkspaceGraph::obstacleFingerprint() const { return DistanceField::fingerprint(_obstacles); }
+
 bool WorkspaceGraph::atGate(GraphNode node)
 {
     double dist = node.distanceTo(_goalRegion);
@@ -44,16 +217,25 @@ bool WorkspaceGraph::atGate(GraphNode node)
 
 bool WorkspaceGraph::nodeIsSafe(const Point p) const
 {
-    for (auto o : _obstacles)
-        if (o->intersects(p))
+    double lower, upper;
+    if (_distanceField && _distanceField->lookup(p, lower, upper))
+    {
+        if (lower > 0)
+            return true;
+        if (upper <= 0)
             return false;
-    return true;
+    }
+
+    if (_obstacleStore.size() <= OBSTACLE_STORE_MAX_LINEAR_SCAN)
+        return !_obstacleStore.intersects(p);
+    return !_obstacleBvh.intersects(p);
 }
 
 bool WorkspaceGraph::pathIsSafe(const GraphNode g1, const GraphNode g2) const
 {
-    auto path = ManeuverEngine::generatePath(g1, g2);
-    return pathIsSafe(path);
+    if (ManeuverEngine::maneuverType == DirectPath)
+        return segmentIsSafe(g1, g2);
+    return maneuverIsSafe(ManeuverEngine::_buildDubinsManeuver(g1, g2));
 }
 
 bool WorkspaceGraph::pathIsSafe(const vector<State>& path) const
@@ -61,19 +243,91 @@ bool WorkspaceGraph::pathIsSafe(const vector<State>& path) const
     if (path.empty())
         return false;
 
-    for (auto s : path)
-        if (!nodeIsSafe(s) || !_nodeInFreespace(s))
+    _counters.pathsChecked.fetch_add(1, memory_order_relaxed);
+    unsigned long samplesBefore = threadSamplesChecked;
+    return _finishPath(_samplesAreSafe(path.data(), path.size()), samplesBefore);
+}
+
+SampleOrder WorkspaceGraph::sampleOrder() const { return _sampleOrder; }
+
+void WorkspaceGraph::setSampleOrder(SampleOrder order) { _sampleOrder = order; }
+
+bool WorkspaceGraph::segmentIsSafe(const Point& p1, const Point& p2) const
+{
+    _counters.pathsChecked.fetch_add(1, memory_order_relaxed);
+
+    // the freespace is a box, so the segment stays inside it iff both end points do
+    if (!intersects(p1) || !intersects(p2))
+        return false;
+
+    return _traceCapsule(p1, p2, 0) || !_obstacleBvh.intersects(Line(p1, p2));
+}
+
+bool WorkspaceGraph::capsuleIsSafe(const Point& p1, const Point& p2, double radius) const
+{
+    _counters.boundsChecked.fetch_add(1, memory_order_relaxed);
+
+    // the freespace is a box, so the capsule stays inside it iff both end points stay at
+    // least the radius away from its sides
+    for (auto p : { p1, p2 })
+        if (p.x() - radius < minX() || p.x() + radius > maxX() ||
+            p.y() - radius < minY() || p.y() + radius > maxY() ||
+            p.z() - radius < minZ() || p.z() + radius > maxZ())
             return false;
 
-    return true;
+    return _traceCapsule(p1, p2, radius) || !_obstacleBvh.intersectsCapsule(Line(p1, p2), radius);
 }
 
-bool WorkspaceGraph::checkAtGoal(const GraphNode node)
+bool WorkspaceGraph::maneuverIsSafe(const DubinsManeuver3d& maneuver) const
 {
-    // update vehicle state to temp node
-    _vehicle.updateState(node);
+    double length = maneuver.length();
+    if (length <= 0)
+        return false;
+    _counters.pathsChecked.fetch_add(1, memory_order_relaxed);
+    unsigned long samplesBefore = threadSamplesChecked;
+
+    // coarse samples are chosen so that refining an interval lands on the regular sample spacing
+    int numFine = ManeuverEngine::sampleCount(length, true);
+    int numCoarse = max((int)ceil((numFine - 1) / (double)MANEUVER_BOUND_REFINEMENT) + 1, MIN_SAMPLES);
 
-    double distToGoal = _vehicle.state().distanceTo(_goalRegion);
+    // scratch buffers are reused across checks on the same thread, so only the Dubins library's
+    // own sampling allocates
+    static thread_local vector<State> coarse, fine;
+    static thread_local vector<int> inconclusive;
+    ManeuverEngine::_sampleDubinsManeuver(maneuver, numCoarse, coarse);
+
+    if (!_samplesAreSafe(coarse.data(), coarse.size()))
+        return _finishPath(false, samplesBefore);
+
+    // samples are evenly spaced in arc length, so the curve between two neighbors is no longer
+    // than the spacing and lies in the ellipsoid with the neighbors as foci; the capsule around
+    // the chord with the ellipsoid's minor radius contains it
+    double spacing = length / (numCoarse - 1);
+    inconclusive.clear();
+    for (int i = 1; i < numCoarse; ++i)
+    {
+        double chord = coarse[i - 1].distanceTo(coarse[i]);
+        double radius = 0.5 * sqrt(max(spacing * spacing - chord * chord, 0.0));
+        if (!capsuleIsSafe(coarse[i - 1], coarse[i], radius))
+            inconclusive.push_back(i);
+    }
+
+    if (inconclusive.empty())
+        return _finishPath(true, samplesBefore);
+
+    // fine sample j lies in coarse interval ceil(j / MANEUVER_BOUND_REFINEMENT); the samples
+    // shared with the coarse pass were already checked. Intervals are refined in the sample order
+    ManeuverEngine::_sampleDubinsManeuver(maneuver, (numCoarse - 1) * MANEUVER_BOUND_REFINEMENT + 1, fine);
+    bool isSafe = visitSamples(inconclusive.size(), _sampleOrder, [&](unsigned long k) {
+        return _samplesAreSafe(&fine[(inconclusive[k] - 1) * MANEUVER_BOUND_REFINEMENT + 1], MANEUVER_BOUND_REFINEMENT - 1);
+    });
+    return _finishPath(isSafe, samplesBefore);
+}
+
+bool WorkspaceGraph::checkAtGoal(const GraphNode& node) const
+{
+    // the bounding radius covers every orientation, so the body nodes don't have to be moved
+    double distToGoal = node.distanceTo(_goalRegion);
     return distToGoal < (_goalRegion.radius() + _vehicle.boundingRadius());
 }
 
@@ -81,4 +335,19 @@ Vehicle WorkspaceGraph::vehicle() { return _vehicle; }
 
 void WorkspaceGraph::setVehicle(Vehicle v) { _vehicle = v; }
 
-GoalState WorkspaceGraph::goalRegion() { return _goalRegion; }
\ No newline at end of file
+GoalState WorkspaceGraph::goalRegion() { return _goalRegion; }
+
+unsigned long WorkspaceGraph::pathsChecked() const { return _counters.pathsChecked; }
+
+unsigned long WorkspaceGraph::samplesChecked() const { return _counters.samplesChecked; }
+
+unsigned long WorkspaceGraph::boundsChecked() const { return _counters.boundsChecked; }
+
+unsigned long WorkspaceGraph::pathsRejected() const { return _counters.pathsRejected; }
+
+unsigned long WorkspaceGraph::rejectionSamples() const { return _counters.rejectionSamples; }
+
+void WorkspaceGraph::resetSampleStats()
+{
+    _counters = SampleCounters();
+}
\ No newline at end of file
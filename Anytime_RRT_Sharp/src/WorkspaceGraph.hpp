@@ -1,32 +1,106 @@
+#include <atomic>
+#include <memory>
 #include <vector>
+#include "DistanceField.hpp"
 #include "ManeuverEngine.hpp"
 #include "Geometry2D.hpp"
 #include "Geometry3D.hpp"
+#include "ObstacleBvh.hpp"
+#include "ObstacleStore.hpp"
 #include "Vehicle.hpp"
 
 #ifndef WORKSPACE_H
 #define WORKSPACE_H
 
+#define MANEUVER_BOUND_REFINEMENT 8     // fine samples per coarse interval whose bound is inconclusive
+#define DISTANCE_FIELD_MIN_TRACE_STEP 0.5   // tracing gives up once steps shrink below this fraction of a voxel
+#define OBSTACLE_STORE_MAX_LINEAR_SCAN 64   // up to this many obstacles, points are scanned in the store instead of the bvh
+
+// order in which the samples of a path are checked
+enum SampleOrder
+{
+    SequentialOrder,    // front to back
+    BisectionOrder      // end points first, then midpoints of ever finer intervals
+};
+
 class WorkspaceGraph : public Rectangle
 {
     GoalState _goalRegion;
     vector<Shape3d*> _obstacles;
+    ObstacleBvh _obstacleBvh;       // rebuilt whenever obstacles are added
+    ObstacleStore _obstacleStore;   // rebuilt whenever obstacles are added
+    shared_ptr<const DistanceField> _distanceField;     // dropped whenever obstacles are added
     Vehicle _vehicle;
     void _buildWorkspaceGraph();
     bool _goalRegionReached;
+    SampleOrder _sampleOrder;
 
-    bool _nodeInFreespace(Point& point) const;
+    // counters written by const checks; atomic so planner threads can share the graph
+    struct SampleCounters
+    {
+        atomic<unsigned long> pathsChecked, samplesChecked, boundsChecked, pathsRejected, rejectionSamples;
+
+        SampleCounters() : pathsChecked(0), samplesChecked(0), boundsChecked(0), pathsRejected(0), rejectionSamples(0) {}
+        SampleCounters(const SampleCounters& counters) { *this = counters; }
+        SampleCounters& operator=(const SampleCounters& counters);
+    };
+    mutable SampleCounters _counters;
+
+    bool _nodeInFreespace(const Point& point) const;
+    bool _sampleIsSafe(const Point& point) const;
+    bool _samplesAreSafe(const State* samples, unsigned long numSamples) const;
+    bool _tracedSamplesAreSafe(const State* samples, unsigned long numSamples) const;
+    bool _finishPath(bool isSafe, unsigned long samplesBefore) const;
+    bool _traceCapsule(const Point& p1, const Point& p2, double radius) const;
 
     public:
         void setGoalRegion(State goalState, double radius);
         void defineFreespace(Rectangle limits);
-        bool checkAtGoal(const GraphNode node);
+        bool checkAtGoal(const GraphNode& node) const;
         bool nodeIsSafe(const Point p) const;
         bool pathIsSafe(const GraphNode g1, const GraphNode g2) const;
+
+        // samples are checked in the sample order, stopping at the first unsafe one; with a
+        // distance field, samples closer to a checked sample than its clearance less the vehicle's
+        // bounding radius are skipped
         bool pathIsSafe(const vector<State>& path) const;
+        SampleOrder sampleOrder() const;
+        void setSampleOrder(SampleOrder order);
+
+        // exact continuous check of the straight segment p1-p2: one intersection test per
+        // obstacle, so thin obstacles between samples cannot be missed
+        bool segmentIsSafe(const Point& p1, const Point& p2) const;
+
+        // conservative check of a capsule around the segment p1-p2: true only if no obstacle can
+        // reach it and it stays in the freespace
+        bool capsuleIsSafe(const Point& p1, const Point& p2, double radius) const;
+
+        // samples the maneuver coarsely and bounds the curve between neighboring samples by a
+        // capsule; only intervals whose capsule is inconclusive are sampled finely
+        bool maneuverIsSafe(const DubinsManeuver3d& maneuver) const;
         void addObstacle(double x, double y, double z, double radius);
         void addObstacles(vector<Shape3d*>& obstacles);
+
+        // with a distance field, point checks are table lookups and segments and capsules are
+        // sphere traced by the clearance; the exact obstacle checks only answer what the field
+        // can't decide, so results are the same with or without it
+        void buildDistanceField(double resolution, int numThreads = 0);
+        void setDistanceField(DistanceField field);
+        void clearDistanceField();
+        bool hasDistanceField() const;
+        const DistanceField& distanceField() const;
+        uint64_t obstacleFingerprint() const;
         bool atGate(GraphNode node);
+
+        // number of paths, path samples and bounding capsules evaluated since the last reset
+        unsigned long pathsChecked() const;
+        unsigned long samplesChecked() const;
+        unsigned long boundsChecked() const;
+
+        // number of sampled paths found unsafe and the samples checked on them until they were
+        unsigned long pathsRejected() const;
+        unsigned long rejectionSamples() const;
+        void resetSampleStats();
         Vehicle vehicle();
         void setVehicle(Vehicle v);
         GoalState goalRegion();
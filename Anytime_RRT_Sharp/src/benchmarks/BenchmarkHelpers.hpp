@@ -0,0 +1,63 @@
+#include <chrono>
+#include <functional>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+#ifndef BENCHMARK_HELPERS_H
+#define BENCHMARK_HELPERS_H
+
+struct BenchmarkCase
+{
+    string name;
+    function<void()> run;
+};
+
+inline vector<BenchmarkCase>& registeredBenchmarks()
+{
+    static vector<BenchmarkCase> benchmarks;
+    return benchmarks;
+}
+
+struct BenchmarkRegistrar
+{
+    BenchmarkRegistrar(string name, function<void()> run) { registeredBenchmarks().push_back({ name, run }); }
+};
+
+// declares and registers a benchmark in the same way gtest's TEST() does
+#define BENCHMARK(suite, name) \
+    void suite##_##name##_Benchmark(); \
+    static BenchmarkRegistrar suite##_##name##_Registrar(#suite "." #name, suite##_##name##_Benchmark); \
+    void suite##_##name##_Benchmark()
+
+// runs the function the given number of times and returns the total wall time in milliseconds
+inline double timeMs(function<void()> func, int repetitions = 1)
+{
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < repetitions; ++i)
+        func();
+    auto stop = high_resolution_clock::now();
+    return duration_cast<duration<double, milli>>(stop - start).count();
+}
+
+inline int runBenchmarks(string filter)
+{
+    int numRun = 0;
+    for (auto& benchmark : registeredBenchmarks())
+    {
+        if (!filter.empty() && benchmark.name.find(filter) == string::npos)
+            continue;
+
+        printf("[ RUN      ] %s\n", benchmark.name.c_str());
+        double elapsed = timeMs(benchmark.run);
+        printf("[     DONE ] %s (%.0f ms)\n", benchmark.name.c_str(), elapsed);
+        ++numRun;
+    }
+    printf("[==========] %d benchmarks ran.\n", numRun);
+    return 0;
+}
+
+#endif //BENCHMARK_HELPERS_H
\ No newline at end of file
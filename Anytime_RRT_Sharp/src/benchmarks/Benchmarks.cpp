@@ -0,0 +1,17 @@
+#include <string>
+#include "BenchmarkHelpers.hpp"
+#include "CollisionBenchmarks.hpp"
+#include "ConfigspaceGraphBenchmarks.hpp"
+#include "ManeuverBenchmarks.hpp"
+#include "MemoryBenchmarks.hpp"
+#include "NodeArenaBenchmarks.hpp"
+#include "NodeIndexBenchmarks.hpp"
+#include "PlannerBenchmarks.hpp"
+
+// usage: ./Benchmarks [filter]
+// runs every registered benchmark whose "Suite.Name" contains the filter string
+int main(int argc, char* argv[])
+{
+    string filter = argc > 1 ? argv[1] : "";
+    return runBenchmarks(filter);
+}
\ No newline at end of file
@@ -0,0 +1,409 @@
+#include <algorithm>
+#include <stdio.h>
+#include <thread>
+#include "BenchmarkHelpers.hpp"
+#include "HeapCounter.hpp"
+#include "../DistanceField.hpp"
+#include "../ManeuverEngine.hpp"
+#include "../ObstacleBvh.hpp"
+#include "../ObstacleStore.hpp"
+#include "../WorkspaceGraph.hpp"
+
+#define COLLISION_BENCHMARK_NUM_EDGES 2000
+#define COLLISION_BENCHMARK_MAX_SAMPLE_STEP 1.0
+#define COLLISION_BENCHMARK_NUM_QUERIES 2000
+
+// random spheres in a 100 x 100 x 100 workspace
+WorkspaceGraph buildClutteredWorkspace(int numObstacles)
+{
+    WorkspaceGraph workGraph;
+    workGraph.defineFreespace(Rectangle(0, 0, 0, 100, 100, 100));
+    for (int i = 0; i < numObstacles; ++i)
+        workGraph.addObstacle(rand() % 100, rand() % 100, rand() % 100, 0.5 + rand() % 20 / 4.0);
+    return workGraph;
+}
+
+BENCHMARK(Collision, DubinsEdgeBounds)
+{
+    srand(15);
+    vector<pair<GraphNode, GraphNode>> edges(COLLISION_BENCHMARK_NUM_EDGES);
+    for (auto& e : edges)
+    {
+        e.first = GraphNode(10 + rand() % 80, 10 + rand() % 80, 10 + rand() % 80, rand() % 628 / 100.0, 0, 1, 0);
+        e.second = GraphNode(e.first.x() + rand() % 40 - 20, e.first.y() + rand() % 40 - 20, e.first.z() + rand() % 20 - 10, rand() % 628 / 100.0, 0, 2, 1);
+    }
+
+    ManeuverEngine::maneuverType = Dubins3d;
+    ManeuverEngine::setMaxSampleStep(COLLISION_BENCHMARK_MAX_SAMPLE_STEP);
+    auto& cache = ManeuverEngine::maneuverCache();
+    unsigned long defaultCapacity = cache.capacity();
+    cache.setCapacity(0);
+
+    printf("%10s %10s %12s %14s %14s %12s %10s\n", "obstacles", "check", "us/edge", "samples/edge", "bounds/edge", "unsafe", "mismatch");
+    for (int numObstacles : { 10, 100, 1000 })
+    {
+        auto workGraph = buildClutteredWorkspace(numObstacles);
+        vector<char> sampledSafe(edges.size()), boundedSafe(edges.size());
+
+        // mismatches are counted against the sampled check, which is run first
+        auto measure = [&](const char* name, vector<char>& results, function<bool(const GraphNode&, const GraphNode&)> isSafe) {
+            workGraph.resetSampleStats();
+            double elapsedMs = timeMs([&]() {
+                for (size_t i = 0; i < edges.size(); ++i)
+                    results[i] = isSafe(edges[i].first, edges[i].second);
+            });
+
+            int numUnsafe = 0, numMismatched = 0;
+            for (size_t i = 0; i < edges.size(); ++i)
+            {
+                numUnsafe += !results[i];
+                numMismatched += results[i] != sampledSafe[i];
+            }
+            printf("%10d %10s %12.2f %14.1f %14.1f %12d %10d\n", numObstacles, name, 1e3 * elapsedMs / edges.size(),
+                workGraph.samplesChecked() / (double)edges.size(), workGraph.boundsChecked() / (double)edges.size(), numUnsafe, numMismatched);
+        };
+
+        measure("sampled", sampledSafe, [&](const GraphNode& g1, const GraphNode& g2) { return workGraph.pathIsSafe(ManeuverEngine::generatePath(g1, g2)); });
+        measure("bounded", boundedSafe, [&](const GraphNode& g1, const GraphNode& g2) { return workGraph.pathIsSafe(g1, g2); });
+    }
+
+    cache.setCapacity(defaultCapacity);
+    ManeuverEngine::setMaxSampleStep(0);
+}
+
+BENCHMARK(Collision, ObstacleBvh)
+{
+    printf("%10s %12s %8s %14s %14s %14s %14s %14s\n", "obstacles", "build (ms)", "depth", "point linear", "point bvh",
+        "segment linear", "segment bvh", "hits agree");
+    for (int numObstacles : { 10, 100, 1000, 10000, 100000 })
+    {
+        // obstacles shrink as they multiply so the workspace stays navigable
+        srand(16);
+        double scale = 10.0 / cbrt((double)numObstacles);
+        vector<Shape3d*> obstacles;
+        for (int i = 0; i < numObstacles; ++i)
+        {
+            double x = rand() % 1000 / 10.0, y = rand() % 1000 / 10.0, z = rand() % 1000 / 10.0;
+            double size = scale * (1 + rand() % 40 / 10.0);
+            if (i % 2)
+                obstacles.push_back(new Sphere(x, y, z, size));
+            else
+                obstacles.push_back(new Rectangle(x, y, z, x + size, y + size, z + size));
+        }
+
+        vector<Line> segments(COLLISION_BENCHMARK_NUM_QUERIES);
+        for (auto& s : segments)
+        {
+            Point p1(rand() % 1000 / 10.0, rand() % 1000 / 10.0, rand() % 1000 / 10.0);
+            s = Line(p1, Point(p1.x() + rand() % 100 / 10.0 - 5, p1.y() + rand() % 100 / 10.0 - 5, p1.z() + rand() % 100 / 10.0 - 5));
+        }
+
+        ObstacleBvh bvh;
+        double buildMs = timeMs([&]() { bvh.build(obstacles); });
+
+        int linearHits = 0, bvhHits = 0;
+        auto linearScan = [&](function<bool(const Shape3d*)> hits) {
+            for (auto o : obstacles)
+                if (hits(o))
+                    return true;
+            return false;
+        };
+
+        double pointLinearMs = timeMs([&]() { for (auto& s : segments) linearHits += linearScan([&](const Shape3d* o) { return o->intersects(s.p1()); }); });
+        double pointBvhMs = timeMs([&]() { for (auto& s : segments) bvhHits += bvh.intersects(s.p1()); });
+        double segmentLinearMs = timeMs([&]() { for (auto& s : segments) linearHits += linearScan([&](const Shape3d* o) { return o->intersects(s); }); });
+        double segmentBvhMs = timeMs([&]() { for (auto& s : segments) bvhHits += bvh.intersects(s); });
+
+        double toUs = 1e3 / COLLISION_BENCHMARK_NUM_QUERIES;
+        printf("%10d %12.2f %8d %14.3f %14.3f %14.3f %14.3f %14s\n", numObstacles, buildMs, bvh.depth(), pointLinearMs * toUs,
+            pointBvhMs * toUs, segmentLinearMs * toUs, segmentBvhMs * toUs, linearHits == bvhHits ? "yes" : "NO");
+
+        for (auto o : obstacles)
+            delete o;
+    }
+    printf("query times in us\n");
+}
+
+BENCHMARK(Collision, DistanceField)
+{
+    printf("%10s %10s %12s %10s %12s %12s %12s %12s %14s %14s\n", "obstacles", "resolution", "build (ms)", "MB", "load (ms)",
+        "point bvh", "point field", "segment bvh", "segment field", "samples/path");
+    for (int numObstacles : { 100, 1000, 10000 })
+    {
+        srand(17);
+        auto workGraph = buildClutteredWorkspace(0);
+        double scale = 10.0 / cbrt((double)numObstacles);
+        vector<Shape3d*> obstacles;
+        for (int i = 0; i < numObstacles; ++i)
+            obstacles.push_back(new Sphere(rand() % 100, rand() % 100, rand() % 100, scale * (1 + rand() % 20 / 4.0)));
+        workGraph.addObstacles(obstacles);
+
+        vector<pair<Point, Point>> segments(COLLISION_BENCHMARK_NUM_QUERIES);
+        for (auto& s : segments)
+        {
+            s.first = Point(rand() % 1000 / 10.0, rand() % 1000 / 10.0, rand() % 1000 / 10.0);
+            s.second = Point(min(max(s.first.x() + rand() % 200 / 10.0 - 10, 0.0), 100.0), min(max(s.first.y() + rand() % 200 / 10.0 - 10, 0.0), 100.0), s.first.z());
+        }
+
+        ManeuverEngine::maneuverType = DirectPath;
+        ManeuverEngine::setMaxSampleStep(COLLISION_BENCHMARK_MAX_SAMPLE_STEP);
+        int hits = 0;
+        auto measureQueries = [&](double& pointUs, double& segmentUs, double& samplesPerPath) {
+            pointUs = 1e3 / segments.size() * timeMs([&]() { for (auto& s : segments) hits += workGraph.nodeIsSafe(s.first); });
+            segmentUs = 1e3 / segments.size() * timeMs([&]() { for (auto& s : segments) hits += workGraph.segmentIsSafe(s.first, s.second); });
+
+            workGraph.resetSampleStats();
+            for (auto& s : segments)
+                hits += workGraph.pathIsSafe(ManeuverEngine::generatePath(State(s.first, 0, 0), State(s.second, 0, 0)));
+            samplesPerPath = workGraph.samplesChecked() / (double)segments.size();
+        };
+
+        double pointBvhUs, segmentBvhUs, samplesBvh;
+        workGraph.clearDistanceField();
+        measureQueries(pointBvhUs, segmentBvhUs, samplesBvh);
+
+        for (double resolution : { 2.0, 1.0 })
+        {
+            double buildMs = timeMs([&]() { workGraph.buildDistanceField(resolution); });
+
+            string fileName = "distance_field_benchmark.bin";
+            workGraph.distanceField().save(fileName);
+            DistanceField loaded;
+            double loadMs = timeMs([&]() { loaded.load(fileName); });
+            remove(fileName.c_str());
+
+            double pointFieldUs, segmentFieldUs, samplesField;
+            measureQueries(pointFieldUs, segmentFieldUs, samplesField);
+            printf("%10d %10.1f %12.1f %10.1f %12.1f %12.3f %12.3f %12.3f %14.3f %7.1f/%5.1f\n", numObstacles, resolution, buildMs,
+                workGraph.distanceField().bytes() / 1e6, loadMs, pointBvhUs, pointFieldUs, segmentBvhUs, segmentFieldUs, samplesBvh, samplesField);
+        }
+
+        for (auto o : obstacles)
+            delete o;
+    }
+
+    ManeuverEngine::setMaxSampleStep(0);
+    printf("query times in us, built on %u threads; samples/path without/with the field\n", max(1u, thread::hardware_concurrency()));
+}
+
+BENCHMARK(Collision, ObstacleStore)
+{
+    auto defaultType = DistanceKernels::kernelType();
+    printf("%10s %10s %14s %14s %16s %10s\n", "obstacles", "check", "us/point", "ns/sample", "Mtests/s", "agree");
+    for (int numObstacles : { 10, 100, 1000, 10000 })
+    {
+        srand(18);
+        double scale = 10.0 / cbrt((double)numObstacles);
+        vector<Shape3d*> obstacles;
+        for (int i = 0; i < numObstacles; ++i)
+        {
+            double x = rand() % 1000 / 10.0, y = rand() % 1000 / 10.0, z = rand() % 1000 / 10.0;
+            double size = scale * (1 + rand() % 40 / 10.0);
+            if (i % 2)
+                obstacles.push_back(new Sphere(x, y, z, size));
+            else
+                obstacles.push_back(new Rectangle(x, y, z, x + size, y + size, z + size));
+        }
+
+        // blocks of samples along short segments, as a sampled path would produce them
+        int blockSize = OBSTACLE_STORE_SAMPLE_BLOCK_SIZE;
+        vector<double> xs(COLLISION_BENCHMARK_NUM_QUERIES * blockSize), ys(xs.size()), zs(xs.size());
+        for (int i = 0; i < COLLISION_BENCHMARK_NUM_QUERIES; ++i)
+        {
+            double x = rand() % 1000 / 10.0, y = rand() % 1000 / 10.0, z = rand() % 1000 / 10.0;
+            double dx = rand() % 100 / 10.0 - 5, dy = rand() % 100 / 10.0 - 5, dz = rand() % 100 / 10.0 - 5;
+            for (int j = 0; j < blockSize; ++j)
+            {
+                xs[i * blockSize + j] = x + dx * j / blockSize;
+                ys[i * blockSize + j] = y + dy * j / blockSize;
+                zs[i * blockSize + j] = z + dz * j / blockSize;
+            }
+        }
+
+        ObstacleBvh bvh(obstacles);
+        ObstacleStore store(obstacles);
+        vector<unsigned long> expectedFirst(COLLISION_BENCHMARK_NUM_QUERIES);
+        int expectedHits = -1;
+
+        // points are the first sample of every block; samples are scanned until the first hit
+        auto measure = [&](const char* name, function<bool(const Point&)> intersects, function<unsigned long(int)> firstIntersecting) {
+            int hits = 0;
+            double pointMs = timeMs([&]() {
+                for (int i = 0; i < COLLISION_BENCHMARK_NUM_QUERIES; ++i)
+                    hits += intersects(Point(xs[i * blockSize], ys[i * blockSize], zs[i * blockSize]));
+            });
+
+            bool agree = expectedHits < 0 || hits == expectedHits;
+            unsigned long numSamples = 0;
+            vector<unsigned long> first(COLLISION_BENCHMARK_NUM_QUERIES);
+            double sampleMs = timeMs([&]() {
+                for (int i = 0; i < COLLISION_BENCHMARK_NUM_QUERIES; ++i)
+                    first[i] = firstIntersecting(i);
+            });
+            for (int i = 0; i < COLLISION_BENCHMARK_NUM_QUERIES; ++i)
+            {
+                numSamples += min(first[i] + 1, (unsigned long)blockSize);
+                agree = agree && (expectedHits < 0 || first[i] == expectedFirst[i]);
+            }
+
+            if (expectedHits < 0)
+            {
+                expectedHits = hits;
+                expectedFirst = first;
+            }
+            printf("%10d %10s %14.3f %14.1f %16.1f %10s\n", numObstacles, name, 1e3 * pointMs / COLLISION_BENCHMARK_NUM_QUERIES,
+                1e6 * sampleMs / numSamples, numSamples * (double)numObstacles / (sampleMs * 1e3), agree ? "yes" : "NO");
+        };
+
+        auto scanBlock = [&](int i, function<bool(const Point&)> intersects) {
+            for (int j = 0; j < blockSize; ++j)
+                if (intersects(Point(xs[i * blockSize + j], ys[i * blockSize + j], zs[i * blockSize + j])))
+                    return (unsigned long)j;
+            return (unsigned long)blockSize;
+        };
+        auto virtualScan = [&](const Point& p) {
+            for (auto o : obstacles)
+                if (o->intersects(p))
+                    return true;
+            return false;
+        };
+        auto bvhQuery = [&](const Point& p) { return bvh.intersects(p); };
+
+        measure("virtual", virtualScan, [&](int i) { return scanBlock(i, virtualScan); });
+        measure("bvh", bvhQuery, [&](int i) { return scanBlock(i, bvhQuery); });
+        for (auto type : { ScalarKernel, Avx2Kernel, Avx512Kernel })
+        {
+            if (!DistanceKernels::isSupported(type))
+                continue;
+            DistanceKernels::setKernelType(type);
+
+            const char* name = type == ScalarKernel ? "scalar" : type == Avx2Kernel ? "avx2" : "avx512";
+            measure(name, [&](const Point& p) { return store.intersects(p); }, [&](int i) {
+                return store.firstIntersecting(&xs[i * blockSize], &ys[i * blockSize], &zs[i * blockSize], blockSize);
+            });
+        }
+        DistanceKernels::setKernelType(defaultType);
+
+        for (auto o : obstacles)
+            delete o;
+    }
+    printf("ns/sample and Mtests/s count the samples up to the first hit of each block of %d\n", OBSTACLE_STORE_SAMPLE_BLOCK_SIZE);
+}
+
+BENCHMARK(Collision, RejectionLatency)
+{
+    printf("%10s %8s %12s %10s %10s %12s %12s %12s\n", "obstacles", "field", "order", "us/path", "rejected",
+        "mean", "p50", "p95");
+    for (int numObstacles : { 30, 1000 })
+    {
+        srand(19);
+        auto workGraph = buildClutteredWorkspace(numObstacles);
+
+        // horizontal edges up to 20 long in each direction, densely sampled
+        ManeuverEngine::maneuverType = DirectPath;
+        ManeuverEngine::setMaxSampleStep(COLLISION_BENCHMARK_MAX_SAMPLE_STEP / 4);
+        vector<vector<State>> paths(COLLISION_BENCHMARK_NUM_QUERIES);
+        for (auto& path : paths)
+        {
+            Point p1(rand() % 1000 / 10.0, rand() % 1000 / 10.0, rand() % 1000 / 10.0);
+            Point p2(min(max(p1.x() + rand() % 400 / 10.0 - 20, 0.0), 100.0), min(max(p1.y() + rand() % 400 / 10.0 - 20, 0.0), 100.0), p1.z());
+            path = ManeuverEngine::generatePath(State(p1, 0, 0), State(p2, 0, 0));
+        }
+
+        for (bool useField : { false, true })
+        {
+            if (useField)
+                workGraph.buildDistanceField(1.0);
+
+            for (auto order : { SequentialOrder, BisectionOrder })
+            {
+                workGraph.setSampleOrder(order);
+                workGraph.resetSampleStats();
+
+                // samples checked on each rejected path
+                vector<unsigned long> latencies;
+                double elapsedMs = timeMs([&]() {
+                    for (auto& path : paths)
+                    {
+                        unsigned long before = workGraph.rejectionSamples();
+                        if (!workGraph.pathIsSafe(path))
+                            latencies.push_back(workGraph.rejectionSamples() - before);
+                    }
+                });
+
+                sort(latencies.begin(), latencies.end());
+                double mean = latencies.empty() ? 0 : workGraph.rejectionSamples() / (double)latencies.size();
+                unsigned long p50 = latencies.empty() ? 0 : latencies[latencies.size() / 2];
+                unsigned long p95 = latencies.empty() ? 0 : latencies[latencies.size() * 95 / 100];
+                printf("%10d %8s %12s %10.2f %10lu %12.1f %12lu %12lu\n", numObstacles, useField ? "yes" : "no",
+                    order == SequentialOrder ? "sequential" : "bisection", 1e3 * elapsedMs / paths.size(), latencies.size(), mean, p50, p95);
+            }
+        }
+    }
+
+    ManeuverEngine::setMaxSampleStep(0);
+    printf("mean, p50 and p95 are samples checked until a path was rejected\n");
+}
+
+// every safety check is run once before counting so that reused scratch buffers have grown
+BENCHMARK(Collision, HeapAllocations)
+{
+    printf("%10s %8s %12s %14s %12s\n", "obstacles", "field", "check", "allocs/check", "ns/check");
+    for (int numObstacles : { 30, 1000 })
+    {
+        srand(20);
+        auto workGraph = buildClutteredWorkspace(numObstacles);
+
+        vector<pair<Point, Point>> segments(COLLISION_BENCHMARK_NUM_QUERIES);
+        for (auto& s : segments)
+        {
+            s.first = Point(rand() % 1000 / 10.0, rand() % 1000 / 10.0, rand() % 1000 / 10.0);
+            s.second = Point(min(max(s.first.x() + rand() % 200 / 10.0 - 10, 0.0), 100.0), min(max(s.first.y() + rand() % 200 / 10.0 - 10, 0.0), 100.0), s.first.z());
+        }
+
+        ManeuverEngine::maneuverType = DirectPath;
+        ManeuverEngine::setMaxSampleStep(COLLISION_BENCHMARK_MAX_SAMPLE_STEP);
+        vector<vector<State>> paths;
+        for (auto& s : segments)
+            paths.push_back(ManeuverEngine::generatePath(State(s.first, 0, 0), State(s.second, 0, 0)));
+
+        vector<DubinsManeuver3d> maneuvers;
+        for (auto& s : segments)
+        {
+            State3d qi { s.first.x(), s.first.y(), s.first.z(), 0, 0 };
+            State3d qf { s.second.x(), s.second.y(), s.second.z(), M_PI / 2, 0 };
+            maneuvers.push_back(DubinsManeuver3d(qi, qf, RHO_MIN, { PITCH_MIN_DEG, PITCH_MAX_DEG }));
+        }
+
+        for (bool useField : { false, true })
+        {
+            if (useField)
+                workGraph.buildDistanceField(1.0);
+
+            int numSafe = 0;
+            auto measure = [&](const char* name, function<bool(int)> isSafe) {
+                for (size_t i = 0; i < segments.size(); ++i)
+                    numSafe += isSafe(i);
+
+                long allocations = HeapCounter::allocations;
+                double elapsedMs = timeMs([&]() {
+                    for (size_t i = 0; i < segments.size(); ++i)
+                        numSafe += isSafe(i);
+                });
+                printf("%10d %8s %12s %14.2f %12.1f\n", numObstacles, useField ? "yes" : "no", name,
+                    (double)(HeapCounter::allocations - allocations) / segments.size(), 1e6 * elapsedMs / segments.size());
+            };
+
+            measure("node", [&](int i) { return workGraph.nodeIsSafe(segments[i].first); });
+            measure("segment", [&](int i) { return workGraph.segmentIsSafe(segments[i].first, segments[i].second); });
+            measure("capsule", [&](int i) { return workGraph.capsuleIsSafe(segments[i].first, segments[i].second, 1.0); });
+            measure("path", [&](int i) { return workGraph.pathIsSafe(paths[i]); });
+            measure("maneuver", [&](int i) { return workGraph.maneuverIsSafe(maneuvers[i]); });
+            if (numSafe == 0)
+                printf("WARN: every check failed\n");
+        }
+    }
+
+    ManeuverEngine::setMaxSampleStep(0);
+    printf("maneuver checks include the allocations of the Dubins library's sampling\n");
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include <unordered_map>
+#include "BenchmarkHelpers.hpp"
+#include "HeapCounter.hpp"
+#include "../ConfigspaceGraph.hpp"
+
+#define PROPAGATE_COST_LEGACY_MAX_NODES 200000
+
+// propagation as it was before the child lists: level by level over copies of a map of child
+// id vectors, each level inserted at the front of the next, with the recomputed costs thrown
+// away. It recursed once per level, which overflows the stack on deep chains, so it is
+// unrolled into a loop here
+void legacyPropagateCost(ConfigspaceGraph& graph, unordered_map<unsigned long, vector<unsigned long>>& parentChildMap, unsigned long updatedNodeId)
+{
+    vector<unsigned long> ids(1, updatedNodeId);
+    while (!ids.empty())
+    {
+        vector<unsigned long> childIds, tempChildIds;
+        for (int id : ids)
+        {
+            tempChildIds = parentChildMap[id];
+            childIds.insert(childIds.begin(), tempChildIds.begin(), tempChildIds.end());
+        }
+
+        ConfigspaceNode node, parent;
+        for (int id : childIds)
+        {
+            node = graph.nodes[id];
+            parent = graph.nodes[node.parentId()];
+            node.setCost(parent.cost() + graph.computeCost(node, parent));
+        }
+        ids = childIds;
+    }
+}
+
+BENCHMARK(ConfigspaceGraph, PropagateCost)
+{
+    ManeuverEngine::maneuverType = DirectPath;
+    printf("%10s %8s %10s %14s %16s %14s %16s\n", "nodes", "tree", "depth", "legacy (ms)", "legacy allocs", "lists (ms)", "lists allocs");
+    for (int numNodes : { 10000, 100000, 1000000 })
+    {
+        for (bool chain : { false, true })
+        {
+            // each node hangs off a random earlier one, or off the previous one for a chain
+            srand(21);
+            ConfigspaceGraph graph;
+            graph.setNodeIndexType(PositionStoreIndex);
+            graph.defineFreespace(Rectangle(0, 0, 0, 100, 100, 100), 3, 0);
+            graph.setRootNode(State(50, 50, 50, 0, 0));
+            unordered_map<unsigned long, vector<unsigned long>> parentChildMap;
+            vector<int> depths(numNodes + 1, 0);
+            for (int i = 1; i < numNodes; ++i)
+            {
+                auto& parent = graph.nodes[chain ? i : 1 + rand() % i];
+                auto node = graph.generateRandomNode();
+                node.setParentId(parent.id());
+                node.setPathLength(node.distanceTo(parent));
+                node.setCost(parent.cost() + node.pathLength());
+                int id = graph.addNode(node);
+                parentChildMap[parent.id()].push_back(id);
+                depths[id] = depths[parent.id()] + 1;
+            }
+            int depth = *max_element(depths.begin(), depths.end());
+
+            // every node below the root changes cost
+            char legacyMs[16] = "-", legacyAllocs[16] = "-";
+            if (numNodes <= PROPAGATE_COST_LEGACY_MAX_NODES)
+            {
+                long allocations = HeapCounter::allocations;
+                snprintf(legacyMs, sizeof(legacyMs), "%.1f", timeMs([&]() { legacyPropagateCost(graph, parentChildMap, 1); }));
+                snprintf(legacyAllocs, sizeof(legacyAllocs), "%ld", HeapCounter::allocations - allocations);
+            }
+
+            // once to size the scratch stack, then measured
+            graph.nodes[1].setCost(-1);
+            graph.propagateCost(1);
+            graph.nodes[1].setCost(-2);
+            long allocations = HeapCounter::allocations;
+            double listsMs = timeMs([&]() { graph.propagateCost(1); });
+            long listsAllocs = HeapCounter::allocations - allocations;
+
+            printf("%10d %8s %10d %14s %16s %14.1f %16ld\n", numNodes, chain ? "chain" : "random", depth, legacyMs, legacyAllocs, listsMs, listsAllocs);
+        }
+    }
+    printf("legacy is skipped above %d nodes\n", PROPAGATE_COST_LEGACY_MAX_NODES);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+#ifndef HEAP_COUNTER_H
+#define HEAP_COUNTER_H
+
+// replaces the global allocation functions to track live heap bytes and allocation counts.
+// must only be included by a single translation unit of an executable
+struct HeapCounter
+{
+    static atomic<long> bytesInUse;
+    static atomic<long> allocations;
+};
+
+atomic<long> HeapCounter::bytesInUse(0);
+atomic<long> HeapCounter::allocations(0);
+
+// each block is prefixed with its size so frees can be subtracted
+#define HEAP_COUNTER_HEADER_SIZE 16
+
+inline void* heapCounterAllocate(size_t size)
+{
+    char* block = (char*)malloc(size + HEAP_COUNTER_HEADER_SIZE);
+    if (!block)
+        throw bad_alloc();
+    *(size_t*)block = size;
+    HeapCounter::bytesInUse += size;
+    ++HeapCounter::allocations;
+    return block + HEAP_COUNTER_HEADER_SIZE;
+}
+
+inline void heapCounterFree(void* ptr)
+{
+    if (!ptr)
+        return;
+    char* block = (char*)ptr - HEAP_COUNTER_HEADER_SIZE;
+    HeapCounter::bytesInUse -= *(size_t*)block;
+    free(block);
+}
+
+void* operator new(size_t size) { return heapCounterAllocate(size); }
+void* operator new[](size_t size) { return heapCounterAllocate(size); }
+void operator delete(void* ptr) noexcept { heapCounterFree(ptr); }
+void operator delete[](void* ptr) noexcept { heapCounterFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { heapCounterFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { heapCounterFree(ptr); }
+
+#endif //HEAP_COUNTER_H
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "BenchmarkHelpers.hpp"
+#include "HeapCounter.hpp"
+#include "../ManeuverEngine.hpp"
+
+#define MANEUVER_BENCHMARK_NUM_PAIRS 2000
+
+// the length evaluation as it was before the cost-only fast path: the maneuver was sampled
+// and copied into a path only to read its length
+double sampledDubinsLength(const State& start, const State& final)
+{
+    State3d qi { start.x(), start.y(), start.z(), start.theta(), start.rho() };
+    State3d qf { final.x(), final.y(), final.z(), final.theta(), final.rho() };
+    DubinsManeuver3d maneuver(qi, qf, RHO_MIN, { PITCH_MIN_DEG, PITCH_MAX_DEG });
+
+    vector<State> path;
+    if (maneuver.length() > 0)
+    {
+        path.resize(NUM_SAMPLES);
+        auto dubinsStates = maneuver.computeSampling(NUM_SAMPLES);
+        for (int i = 0; i < NUM_SAMPLES; ++i)
+            path[i] = State(dubinsStates.at(i).x, dubinsStates.at(i).y, dubinsStates.at(i).z, dubinsStates.at(i).theta, dubinsStates.at(i).gamma);
+    }
+    return maneuver.length();
+}
+
+BENCHMARK(Maneuver, DubinsLengthOnly)
+{
+    srand(12);
+    vector<pair<State, State>> pairs(MANEUVER_BENCHMARK_NUM_PAIRS);
+    for (auto& p : pairs)
+    {
+        p.first = State(rand() % 100, rand() % 100, rand() % 40, rand() % 628 / 100.0, 0);
+        p.second = State(rand() % 100, rand() % 100, rand() % 40, rand() % 628 / 100.0, 0);
+    }
+
+    ManeuverEngine::maneuverType = Dubins3d;
+    auto& cache = ManeuverEngine::maneuverCache();
+    unsigned long defaultCapacity = cache.capacity();
+    double sum = 0;
+
+    auto measure = [&](const char* name, function<double(const State&, const State&)> length) {
+        long allocations = HeapCounter::allocations;
+        double elapsedMs = timeMs([&]() { for (auto& p : pairs) sum += length(p.first, p.second); });
+        printf("%16s %14.1f %16.2f\n", name, 1e6 * elapsedMs / pairs.size(), (double)(HeapCounter::allocations - allocations) / pairs.size());
+    };
+
+    printf("%16s %14s %16s\n", "evaluation", "ns/call", "allocations/call");
+    measure("sampled", sampledDubinsLength);
+
+    cache.setCapacity(0);
+    measure("length-only", ManeuverEngine::getPathLength);
+
+    cache.setCapacity(defaultCapacity);
+    cache.clear();
+    measure("cache miss", ManeuverEngine::getPathLength);
+    measure("cache hit", ManeuverEngine::getPathLength);
+
+    if (sum == 0)
+        printf("WARN: no maneuvers evaluated\n");
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include "BenchmarkHelpers.hpp"
+#include "HeapCounter.hpp"
+#include "../ArrtsParams.hpp"
+#include "../ArrtsService.hpp"
+
+// heap held by a planned graph; nodes used to carry NUM_SAMPLES sampled States of their
+// incoming maneuver, which is shown as the per-node cost it would add back
+BENCHMARK(Memory, PlannedGraph)
+{
+    printf("%10s %10s %16s %14s %20s\n", "nodes", "maneuver", "graph heap (MB)", "bytes/node", "sampled path (B/node)");
+
+    for (int numNodes : { 5000, 20000 })
+    {
+        for (ManeuverType maneuverType : { DirectPath, Dubins3d })
+        {
+            ArrtsParams params("./test", numNodes);
+            long before = HeapCounter::bytesInUse;
+            {
+                ArrtsService service;
+                service.calculatePath(params, "", maneuverType);
+                long graphBytes = HeapCounter::bytesInUse - before;
+
+                printf("%10d %10s %16.2f %14.0f %20lu\n", numNodes, maneuverType == DirectPath ? "direct" : "dubins",
+                    graphBytes / 1e6, (double)graphBytes / numNodes, NUM_SAMPLES * sizeof(State) + sizeof(vector<State>));
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include <unordered_map>
+#include "BenchmarkHelpers.hpp"
+#include "../NodeArena.hpp"
+
+#define NODE_ARENA_NUM_LOOKUPS 1000000
+
+// compares the arena against the unordered_map it replaced for the access patterns the
+// planner uses: sequential inserts, random lookups by parent id and full iteration
+BENCHMARK(NodeArena, VersusUnorderedMap)
+{
+    printf("%10s %14s %12s %16s %16s\n", "nodes", "storage", "insert (ms)", "lookup (ns/q)", "iterate (ms)");
+
+    for (unsigned long numNodes : { 20000ul, 1000000ul })
+    {
+        vector<unsigned long> lookups(NODE_ARENA_NUM_LOOKUPS);
+        srand(numNodes);
+        for (auto& id : lookups)
+            id = 1 + rand() % numNodes;
+
+        double sum = 0;
+        unordered_map<unsigned long, ConfigspaceNode> map;
+        double insertMs = timeMs([&]() {
+            for (unsigned long id = 1; id <= numNodes; ++id)
+                map[id] = ConfigspaceNode(id, 0, 0, 0, 0, id, id - 1, id);
+        });
+        double lookupMs = timeMs([&]() { for (auto id : lookups) sum += map[id].cost(); });
+        double iterateMs = timeMs([&]() { for (auto itr = map.begin(); itr != map.end(); ++itr) sum += itr->second.cost(); });
+        printf("%10lu %14s %12.1f %16.1f %16.2f\n", numNodes, "unordered_map", insertMs, 1e6 * lookupMs / NODE_ARENA_NUM_LOOKUPS, iterateMs);
+
+        NodeArena arena;
+        insertMs = timeMs([&]() {
+            for (unsigned long id = 1; id <= numNodes; ++id)
+                arena.insert(ConfigspaceNode(id, 0, 0, 0, 0, id, id - 1, id));
+        });
+        lookupMs = timeMs([&]() { for (auto id : lookups) sum += arena[id].cost(); });
+        iterateMs = timeMs([&]() { for (auto& node : arena) sum += node.cost(); });
+        printf("%10lu %14s %12.1f %16.1f %16.2f\n", numNodes, "arena", insertMs, 1e6 * lookupMs / NODE_ARENA_NUM_LOOKUPS, iterateMs);
+
+        if (sum == 0)
+            printf("WARN: no nodes visited\n");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "BenchmarkHelpers.hpp"
+#include "../ArrtsParams.hpp"
+#include "../ConfigspaceGraph.hpp"
+#include "../DistanceKernels.hpp"
+
+#define NODE_INDEX_NUM_QUERIES 500
+
+ConfigspaceGraph buildRandomGraph(int numNodes, NodeIndexType indexType = KdTreeIndex)
+{
+    ConfigspaceGraph graph;
+    graph.setNodeIndexType(indexType);
+    graph.defineFreespace(Rectangle(0, 0, 0, 1000, 1000, 1000), 3, 0);
+    graph.setRootNode(State(500, 500, 500, 0, 0));
+    for (int i = 1; i < numNodes; ++i)
+        graph.addNode(graph.generateRandomNode());
+    return graph;
+}
+
+unsigned long findClosestNodeByScan(ConfigspaceGraph& graph, GraphNode& node)
+{
+    double dist, shortestDist = INFINITY;
+    unsigned long closestNodeId = 0;
+    for (auto& n : graph.nodes)
+    {
+        dist = n.distanceTo(node);
+        if (dist < shortestDist)
+        {
+            shortestDist = dist;
+            closestNodeId = n.id();
+        }
+    }
+    return closestNodeId;
+}
+
+vector<unsigned long> findNeighborsByScan(ConfigspaceGraph& graph, GraphNode& node, double radius, int k)
+{
+    vector<unsigned long> neighbors;
+    for (auto& n : graph.nodes)
+    {
+        if (n.distanceTo(node) < radius)
+        {
+            neighbors.push_back(n.id());
+            if (neighbors.size() >= (size_t)k)
+                return neighbors;
+        }
+    }
+    return neighbors;
+}
+
+BENCHMARK(NodeIndex, FindClosestParentNode)
+{
+    srand(1);
+    printf("%10s %12s %14s %14s %10s\n", "nodes", "build (ms)", "scan (us/q)", "index (us/q)", "speedup");
+
+    for (int numNodes : { 20000, 100000, 1000000 })
+    {
+        ConfigspaceGraph graph;
+        double buildMs = timeMs([&]() { graph = buildRandomGraph(numNodes); });
+
+        vector<ConfigspaceNode> queries(NODE_INDEX_NUM_QUERIES);
+        for (auto& q : queries)
+            q = graph.generateRandomNode();
+
+        unsigned long scanSum = 0, indexSum = 0;
+        double scanMs = timeMs([&]() { for (auto& q : queries) scanSum += findClosestNodeByScan(graph, q); });
+        double indexMs = timeMs([&]() { for (auto& q : queries) indexSum += graph.findClosestParentNode(q).id(); });
+
+        if (scanSum != indexSum)
+            printf("WARN: index and scan results differ\n");
+
+        printf("%10d %12.1f %14.2f %14.2f %9.1fx\n", numNodes, buildMs,
+            1000.0 * scanMs / NODE_INDEX_NUM_QUERIES, 1000.0 * indexMs / NODE_INDEX_NUM_QUERIES, scanMs / indexMs);
+    }
+}
+
+BENCHMARK(NodeIndex, FindNeighbors)
+{
+    srand(2);
+    int k = DEFAULT_MAX_NEIGHBOR_COUNT;
+    double epsilon = 50;
+    printf("%10s %14s %14s %10s\n", "nodes", "scan (us/q)", "index (us/q)", "speedup");
+
+    for (int numNodes : { 20000, 100000 })
+    {
+        ConfigspaceGraph graph = buildRandomGraph(numNodes);
+
+        vector<ConfigspaceNode> queries(NODE_INDEX_NUM_QUERIES);
+        for (auto& q : queries)
+            q = graph.generateRandomNode();
+
+        // the scan returns hash-order neighbors; the index returns the true k closest
+        double radius = graph.neighborRadius(epsilon);
+        unsigned long scanCount = 0, indexCount = 0;
+        double scanMs = timeMs([&]() { for (auto& q : queries) scanCount += findNeighborsByScan(graph, q, radius, k).size(); });
+        double indexMs = timeMs([&]() { for (auto& q : queries) indexCount += graph.findNeighbors(q, epsilon, k).size(); });
+
+        printf("%10d %14.2f %14.2f %9.1fx\n", numNodes,
+            1000.0 * scanMs / NODE_INDEX_NUM_QUERIES, 1000.0 * indexMs / NODE_INDEX_NUM_QUERIES, scanMs / indexMs);
+    }
+}
+
+const char* nodeIndexName(NodeIndexType indexType)
+{
+    if (indexType == SpatialHashIndex)
+        return "grid";
+    if (indexType == PositionStoreIndex)
+        return "soa-scan";
+    return "kd-tree";
+}
+
+BENCHMARK(NodeIndex, GridVsTree)
+{
+    srand(4);
+    int k = DEFAULT_MAX_NEIGHBOR_COUNT;
+    double epsilon = 50;
+    printf("%10s %10s %12s %16s %16s\n", "nodes", "index", "build (ms)", "nearest (us/q)", "neighbors (us/q)");
+
+    for (int numNodes : { 20000, 100000, 1000000 })
+    {
+        for (NodeIndexType indexType : { KdTreeIndex, SpatialHashIndex, PositionStoreIndex })
+        {
+            srand(numNodes);
+            ConfigspaceGraph graph;
+            double buildMs = timeMs([&]() { graph = buildRandomGraph(numNodes, indexType); });
+
+            vector<ConfigspaceNode> queries(NODE_INDEX_NUM_QUERIES);
+            for (auto& q : queries)
+                q = graph.generateRandomNode();
+
+            // first neighbor query lets the grid settle on the current radius
+            graph.findNeighbors(queries[0], epsilon, k);
+
+            unsigned long sum = 0;
+            double nearestMs = timeMs([&]() { for (auto& q : queries) sum += graph.findClosestParentNode(q).id(); });
+            double neighborsMs = timeMs([&]() { for (auto& q : queries) sum += graph.findNeighbors(q, epsilon, k).size(); });
+
+            printf("%10d %10s %12.1f %16.2f %16.2f\n", numNodes, nodeIndexName(indexType), buildMs,
+                1000.0 * nearestMs / NODE_INDEX_NUM_QUERIES, 1000.0 * neighborsMs / NODE_INDEX_NUM_QUERIES);
+        }
+    }
+}
+
+BENCHMARK(NodeIndex, BatchQueries)
+{
+    srand(7);
+    int k = DEFAULT_MAX_NEIGHBOR_COUNT;
+    double epsilon = 50;
+    int numSamples = 4096;
+    int maxThreads = max(1, (int)thread::hardware_concurrency());
+    printf("%10s %10s %8s %16s %16s %16s\n", "nodes", "index", "threads", "single (us/q)", "batch (us/q)", "speedup");
+
+    for (int numNodes : { 20000, 1000000 })
+    {
+        for (NodeIndexType indexType : { KdTreeIndex, PositionStoreIndex })
+        {
+            srand(numNodes);
+            ConfigspaceGraph graph = buildRandomGraph(numNodes, indexType);
+
+            vector<ConfigspaceNode> samples(numSamples);
+            for (auto& sample : samples)
+                sample = graph.generateRandomNode();
+
+            // one call per sample, as the planner loop issues them today
+            unsigned long sum = 0;
+            double singleMs = timeMs([&]() {
+                for (auto& sample : samples)
+                {
+                    sample.setParentId(graph.findClosestParentNode(sample).id());
+                    sum += graph.findNeighbors(sample, epsilon, k).size();
+                }
+            });
+
+            for (int numThreads : { 1, maxThreads })
+            {
+                double batchMs = timeMs([&]() {
+                    for (auto& neighborhood : graph.findNeighborhoods(samples, epsilon, k, numThreads))
+                        sum += neighborhood.neighborIds.size();
+                });
+
+                printf("%10d %10s %8d %16.2f %16.2f %15.1fx\n", numNodes, nodeIndexName(indexType), numThreads,
+                    1000.0 * singleMs / numSamples, 1000.0 * batchMs / numSamples, singleMs / batchMs);
+                if (maxThreads == 1)
+                    break;
+            }
+        }
+    }
+}
+
+BENCHMARK(NodeIndex, DistanceKernels)
+{
+    srand(6);
+    auto defaultType = DistanceKernels::kernelType();
+    printf("%10s %10s %16s %16s\n", "points", "kernel", "nearest (us/q)", "Mpoints/s");
+
+    for (int numPoints : { 1000, 20000, 100000 })
+    {
+        vector<double> xs(numPoints), ys(numPoints), zs(numPoints);
+        for (int i = 0; i < numPoints; ++i)
+        {
+            xs[i] = rand() % 100000 / 100.0;
+            ys[i] = rand() % 100000 / 100.0;
+            zs[i] = rand() % 100000 / 100.0;
+        }
+
+        for (auto type : { ScalarKernel, Avx2Kernel, Avx512Kernel })
+        {
+            if (!DistanceKernels::isSupported(type))
+                continue;
+            DistanceKernels::setKernelType(type);
+
+            unsigned long sum = 0;
+            double best, point[3] = { 500, 500, 500 };
+            double elapsedMs = timeMs([&]() {
+                point[0] += 0.001;
+                sum += DistanceKernels::nearestIndex(xs.data(), ys.data(), zs.data(), numPoints, point, best);
+            }, NODE_INDEX_NUM_QUERIES);
+
+            const char* name = type == ScalarKernel ? "scalar" : type == Avx2Kernel ? "avx2" : "avx512";
+            printf("%10d %10s %16.2f %16.1f\n", numPoints, name, 1000.0 * elapsedMs / NODE_INDEX_NUM_QUERIES,
+                (double)numPoints * NODE_INDEX_NUM_QUERIES / (elapsedMs * 1000.0));
+        }
+    }
+    DistanceKernels::setKernelType(defaultType);
+}
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "BenchmarkHelpers.hpp"
+#include "../ArrtsParams.hpp"
+#include "../ArrtsService.hpp"
+
+#define PLANNER_BENCHMARK_NODE_COUNT 5000
+#define PLANNER_BENCHMARK_RUNS 3
+#define ENGINE_MODE_BENCHMARK_RUNS 8    // seeded runs per node count; costs vary far more than runtimes
+#define THREAD_SCALING_NODE_COUNT 20000
+
+struct PlannerResult
+{
+    double cost, runtimeMs;
+};
+
+// runs the planner on the test scenario and returns the final cost and wall time
+PlannerResult runPlanner(ArrtsParams params, ManeuverType maneuverType)
+{
+    ArrtsService service;
+    vector<State> path;
+    double runtimeMs = timeMs([&]() { path = service.calculatePath(params, "", maneuverType); });
+
+    double cost = 0;
+    for (size_t i = 1; i < path.size(); ++i)
+        cost += path[i].distanceTo(path[i - 1]);
+
+    return { cost, runtimeMs };
+}
+
+BENCHMARK(Planner, NeighborCount)
+{
+    vector<string> lines;
+    for (int k : { 5, 10, 15 })
+    {
+        double costSum = 0, runtimeSum = 0;
+        for (int i = 0; i < PLANNER_BENCHMARK_RUNS; ++i)
+        {
+            auto result = runPlanner(ArrtsParams("./test", PLANNER_BENCHMARK_NODE_COUNT, k), DirectPath);
+            costSum += result.cost;
+            runtimeSum += result.runtimeMs;
+        }
+
+        char line[128];
+        snprintf(line, sizeof(line), "%10d %16.3f %14.1f", k, costSum / PLANNER_BENCHMARK_RUNS, runtimeSum / PLANNER_BENCHMARK_RUNS);
+        lines.push_back(line);
+    }
+
+    printf("%10s %16s %14s\n", "neighbors", "path length", "runtime (ms)");
+    for (auto& line : lines)
+        printf("%s\n", line.c_str());
+}
+
+BENCHMARK(Planner, NodeIndexType)
+{
+    vector<string> lines;
+    for (NodeIndexType indexType : { KdTreeIndex, SpatialHashIndex, PositionStoreIndex })
+    {
+        double costSum = 0, runtimeSum = 0;
+        for (int i = 0; i < PLANNER_BENCHMARK_RUNS; ++i)
+        {
+            ArrtsParams params("./test", PLANNER_BENCHMARK_NODE_COUNT);
+            params.setNodeIndexType(indexType);
+            auto result = runPlanner(params, DirectPath);
+            costSum += result.cost;
+            runtimeSum += result.runtimeMs;
+        }
+
+        char line[128];
+        snprintf(line, sizeof(line), "%10s %16.3f %14.1f", nodeIndexName(indexType),
+            costSum / PLANNER_BENCHMARK_RUNS, runtimeSum / PLANNER_BENCHMARK_RUNS);
+        lines.push_back(line);
+    }
+
+    printf("%10s %16s %14s\n", "index", "path length", "runtime (ms)");
+    for (auto& line : lines)
+        printf("%s\n", line.c_str());
+}
+
+BENCHMARK(Planner, ApproximateNeighbors)
+{
+    // one line per error bound so path length can be plotted against runtime
+    vector<string> lines;
+    for (double epsilon : { 0.0, 0.1, 0.25, 0.5, 1.0, 2.0 })
+    {
+        double costSum = 0, runtimeSum = 0;
+        for (int i = 0; i < PLANNER_BENCHMARK_RUNS; ++i)
+        {
+            srand(i);
+            ArrtsParams params("./test", PLANNER_BENCHMARK_NODE_COUNT);
+            params.setNeighborApproximationError(epsilon);
+            auto result = runPlanner(params, DirectPath);
+            costSum += result.cost;
+            runtimeSum += result.runtimeMs;
+        }
+
+        char line[128];
+        snprintf(line, sizeof(line), "%10.2f %16.3f %14.1f", epsilon, costSum / PLANNER_BENCHMARK_RUNS, runtimeSum / PLANNER_BENCHMARK_RUNS);
+        lines.push_back(line);
+    }
+
+    printf("%10s %16s %14s\n", "epsilon", "path length", "runtime (ms)");
+    for (auto& line : lines)
+        printf("%s\n", line.c_str());
+}
+
+BENCHMARK(Planner, ManeuverCacheSize)
+{
+    vector<string> lines;
+    for (unsigned long capacityMb : { 0ul, 1ul, 16ul, 64ul })
+    {
+        double costSum = 0, runtimeSum = 0, hitRateSum = 0;
+        for (int i = 0; i < PLANNER_BENCHMARK_RUNS; ++i)
+        {
+            ManeuverEngine::maneuverCache().clear();
+            ArrtsParams params("./test", PLANNER_BENCHMARK_NODE_COUNT);
+            params.setManeuverCacheBytes(capacityMb << 20);
+            auto result = runPlanner(params, Dubins3d);
+            costSum += result.cost;
+            runtimeSum += result.runtimeMs;
+
+            auto stats = ManeuverEngine::maneuverCache().stats();
+            hitRateSum += stats.hits + stats.misses ? (double)stats.hits / (stats.hits + stats.misses) : 0;
+        }
+
+        char line[128];
+        snprintf(line, sizeof(line), "%12lu %16.3f %14.1f %10.1f%%", capacityMb, costSum / PLANNER_BENCHMARK_RUNS,
+            runtimeSum / PLANNER_BENCHMARK_RUNS, 100.0 * hitRateSum / PLANNER_BENCHMARK_RUNS);
+        lines.push_back(line);
+    }
+    ManeuverEngine::maneuverCache().setCapacity(DEFAULT_MANEUVER_CACHE_BYTES);
+
+    printf("%12s %16s %14s %11s\n", "cache (MB)", "path length", "runtime (ms)", "hit rate");
+    for (auto& line : lines)
+        printf("%s\n", line.c_str());
+}
+
+// DirectPath edges are checked exactly, so only Dubins3d edges are sampled
+BENCHMARK(Planner, MaxSampleStep)
+{
+    vector<string> lines;
+    for (double step : { 0.0, 1.0, 2.0, (double)AUTO_MAX_SAMPLE_STEP, 8.0 })
+    {
+        double costSum = 0, runtimeSum = 0, samplesSum = 0;
+        for (int i = 0; i < PLANNER_BENCHMARK_RUNS; ++i)
+        {
+            ArrtsParams params("./test", PLANNER_BENCHMARK_NODE_COUNT);
+            params.setMaxSampleStep(step);
+            step = params.maxSampleStep();
+            ArrtsService service;
+            vector<State> path;
+            runtimeSum += timeMs([&]() { path = service.calculatePath(params, "", Dubins3d); });
+            for (size_t j = 1; j < path.size(); ++j)
+                costSum += path[j].distanceTo(path[j - 1]);
+            samplesSum += service.workspaceGraph().samplesChecked();
+        }
+
+        char line[128];
+        snprintf(line, sizeof(line), "%10.2f %16.3f %14.1f %16.0f", step, costSum / PLANNER_BENCHMARK_RUNS,
+            runtimeSum / PLANNER_BENCHMARK_RUNS, samplesSum / PLANNER_BENCHMARK_RUNS);
+        lines.push_back(line);
+    }
+    ManeuverEngine::setMaxSampleStep(0);
+
+    printf("%10s %16s %14s %16s\n", "max step", "path length", "runtime (ms)", "samples checked");
+    for (auto& line : lines)
+        printf("%s\n", line.c_str());
+}
+
+// both modes are run to increasing node counts; the time to reach a cost is the runtime of
+// the smallest node count whose mean cost is within the target
+BENCHMARK(Planner, EngineMode)
+{
+    vector<int> nodeCounts = { 1000, 2000, 4000, 8000, 16000 };
+    vector<EngineMode> modes = { RrtStarMode, RrtSharpMode };
+    vector<vector<PlannerResult>> results(modes.size());
+    double bestCost = INFINITY;
+
+    for (size_t m = 0; m < modes.size(); ++m)
+    {
+        for (int nodeCount : nodeCounts)
+        {
+            double costSum = 0, runtimeSum = 0;
+            for (int i = 0; i < ENGINE_MODE_BENCHMARK_RUNS; ++i)
+            {
+                ArrtsParams params("./test", nodeCount);
+                params.setEngineMode(modes[m]);
+                params.setRandomSeed(i + 1);
+                ArrtsService service;
+                runtimeSum += timeMs([&]() { service.calculatePath(params, "", DirectPath); });
+                costSum += service.configspaceGraph().goalNodes().bestCost();
+            }
+            results[m].push_back({ costSum / ENGINE_MODE_BENCHMARK_RUNS, runtimeSum / ENGINE_MODE_BENCHMARK_RUNS });
+            bestCost = min(bestCost, results[m].back().cost);
+        }
+    }
+
+    printf("%6s %10s %16s %14s\n", "mode", "nodes", "goal cost", "runtime (ms)");
+    for (size_t m = 0; m < modes.size(); ++m)
+        for (size_t i = 0; i < nodeCounts.size(); ++i)
+            printf("%6s %10d %16.3f %14.1f\n", modes[m] == RrtSharpMode ? "RRT#" : "RRT*", nodeCounts[i], results[m][i].cost, results[m][i].runtimeMs);
+
+    printf("\n%6s %16s %18s\n", "mode", "target cost", "time to target (ms)");
+    for (double margin : { 0.01, 0.005, 0.002 })
+    {
+        for (size_t m = 0; m < modes.size(); ++m)
+        {
+            double target = bestCost * (1 + margin);
+            auto reached = find_if(results[m].begin(), results[m].end(), [&](const PlannerResult& r) { return r.cost <= target; });
+            if (reached == results[m].end())
+                printf("%6s %16.3f %18s\n", modes[m] == RrtSharpMode ? "RRT#" : "RRT*", target, "not reached");
+            else
+                printf("%6s %16.3f %18.1f\n", modes[m] == RrtSharpMode ? "RRT#" : "RRT*", target, reached->runtimeMs);
+        }
+    }
+}
+
+// speedups are relative to the single threaded run, which expands one sample at a time; they
+// are bounded by the hardware threads and by the share of the work done in the serial commits
+BENCHMARK(Planner, ThreadScaling)
+{
+    printf("Hardware threads: %u\n", thread::hardware_concurrency());
+    printf("%10s %8s %16s %14s %10s\n", "maneuver", "threads", "goal cost", "runtime (ms)", "speedup");
+    for (ManeuverType maneuverType : { DirectPath, Dubins3d })
+    {
+        double baseRuntime = 0;
+        for (int numThreads : { 1, 2, 4, 8, 16 })
+        {
+            double costSum = 0, runtimeSum = 0;
+            for (int i = 0; i < PLANNER_BENCHMARK_RUNS; ++i)
+            {
+                ArrtsParams params("./test", THREAD_SCALING_NODE_COUNT);
+                params.setNumThreads(numThreads);
+                params.setRandomSeed(i + 1);
+                ArrtsService service;
+                runtimeSum += timeMs([&]() { service.calculatePath(params, "", maneuverType); });
+                costSum += service.configspaceGraph().goalNodes().bestCost();
+            }
+
+            double runtime = runtimeSum / PLANNER_BENCHMARK_RUNS;
+            if (numThreads == 1)
+                baseRuntime = runtime;
+            printf("%10s %8d %16.3f %14.1f %9.2fx\n", maneuverType == DirectPath ? "DirectPath" : "Dubins3d",
+                numThreads, costSum / PLANNER_BENCHMARK_RUNS, runtime, baseRuntime / runtime);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include "../ArrtsEngine.hpp"
+#include "../ArrtsParams.hpp"
+
+#pragma region ArrtsEngine
+
+// runs the engine on the test scenario the way the service sets it up
+unsigned long runEngineOnTestData(ConfigspaceGraph& configGraph, WorkspaceGraph& workGraph, EngineMode mode, int minNodeCount, double timeBudgetMs = NO_TIME_BUDGET, PlannerHandle* handle = nullptr, int numThreads = 1, unsigned int seed = TIME_RANDOM_SEED)
+{
+    ArrtsParams params("./test", minNodeCount);
+    params.setEngineMode(mode);
+    params.setTimeBudgetMs(timeBudgetMs);
+    params.setNumThreads(numThreads);
+    params.setRandomSeed(seed);
+
+    workGraph.setGoalRegion(params.goal(), params.goalRadius());
+    workGraph.defineFreespace(params.limits());
+    workGraph.addObstacles(params.obstacles());
+    workGraph.setVehicle(params.vehicle());
+
+    configGraph.defineFreespace(params.limits(), params.dimension(), params.obstacleVolume());
+    configGraph.setRootNode(params.start());
+
+    return ArrtsEngine::runArrtsOnGraphs(configGraph, workGraph, params, DirectPath, handle);
+}
+
+// every node is reached from the root through edges matching the parent ids, and costs only ever
+// decrease, so a node is never cheaper than its parent's cost plus its edge
+void expectTreeIsConsistent(ConfigspaceGraph& configGraph)
+{
+    GTEST_ASSERT_EQ(configGraph.edges.size(), configGraph.nodes.size() - 1);
+    for (auto& edge : configGraph.edges)
+        GTEST_ASSERT_EQ(configGraph.nodes[edge.end().id()].parentId(), edge.start().id());
+
+    for (auto& node : configGraph.nodes)
+    {
+        auto current = node;
+        for (int depth = 0; current.parentId(); ++depth)
+        {
+            ASSERT_LT(depth, configGraph.nodes.size());
+            auto& parent = configGraph.nodes[current.parentId()];
+            EXPECT_GE(current.cost(), parent.cost() + current.pathLength() - 1e-9);
+            current = parent;
+        }
+        GTEST_ASSERT_EQ(current.id(), 1);
+    }
+}
+
+TEST(ArrtsEngine, RrtSharpMode_TreeStaysAcyclic)
+{
+    ConfigspaceGraph configGraph;
+    WorkspaceGraph workGraph;
+    runEngineOnTestData(configGraph, workGraph, RrtSharpMode, 2000);
+    expectTreeIsConsistent(configGraph);
+}
+
+TEST(ArrtsEngine, RrtSharpMode_BestGoalNodeIsConsistent)
+{
+    ConfigspaceGraph configGraph;
+    WorkspaceGraph workGraph;
+    runEngineOnTestData(configGraph, workGraph, RrtSharpMode, 2000);
+
+    ConfigspaceNode bestNode;
+    double bestCost = INFINITY;
+    for (auto& node : configGraph.nodes)
+    {
+        if (workGraph.checkAtGoal(node) && node.cost() < bestCost)
+        {
+            bestCost = node.cost();
+            bestNode = node;
+        }
+    }
+    ASSERT_TRUE(bestNode.id());
+
+    // every node on the path to the best goal node was expanded, so its cost is exact
+    double pathCost = 0;
+    for (auto node = bestNode; node.parentId(); node = configGraph.nodes[node.parentId()])
+        pathCost += node.pathLength();
+    EXPECT_NEAR(bestCost, pathCost, 1e-9);
+}
+
+// the budget is checked between steps, so a run may only overrun it by one of them; the bound
+// also covers loading the test scenario
+void expectStopsWithinBudget(EngineMode mode, int numThreads)
+{
+    const double budgetMs = 50;
+    ConfigspaceGraph configGraph;
+    WorkspaceGraph workGraph;
+    auto start = steady_clock::now();
+    runEngineOnTestData(configGraph, workGraph, mode, 10000000, budgetMs, nullptr, numThreads);
+    auto elapsedMs = duration_cast<milliseconds>(steady_clock::now() - start).count();
+
+    EXPECT_LT(configGraph.nodes.size(), 10000000);
+    EXPECT_LT(elapsedMs, 4 * budgetMs);
+}
+
+TEST(ArrtsEngine, RrtSharpMode_NoCostlierThanRrtStar)
+{
+    // both modes draw the same samples from a seed; RRT# only skips expansions that can't lower
+    // the goal cost, so it never ends up with a costlier path
+    ConfigspaceGraph starConfigGraph, sharpConfigGraph;
+    WorkspaceGraph starWorkGraph, sharpWorkGraph;
+    auto starBestId = runEngineOnTestData(starConfigGraph, starWorkGraph, RrtStarMode, 2000, NO_TIME_BUDGET, nullptr, 1, 4);
+    auto sharpBestId = runEngineOnTestData(sharpConfigGraph, sharpWorkGraph, RrtSharpMode, 2000, NO_TIME_BUDGET, nullptr, 1, 4);
+
+    ASSERT_TRUE(starBestId);
+    ASSERT_TRUE(sharpBestId);
+    EXPECT_LE(sharpConfigGraph.nodes[sharpBestId].cost(), starConfigGraph.nodes[starBestId].cost() + 1e-9);
+}
+
+TEST(ArrtsEngine, TimeBudget_StopsBeforeNodeCount)
+{
+    expectStopsWithinBudget(RrtStarMode, 1);
+}
+
+TEST(ArrtsEngine, TimeBudget_RrtSharpModeStopsBeforeNodeCount)
+{
+    expectStopsWithinBudget(RrtSharpMode, 1);
+}
+
+TEST(ArrtsEngine, TimeBudget_ParallelModeStopsBeforeNodeCount)
+{
+    expectStopsWithinBudget(RrtStarMode, 4);
+}
+
+TEST(ArrtsEngine, Handle_PublishesStrictlyCheaperPaths)
+{
+    ConfigspaceGraph configGraph;
+    WorkspaceGraph workGraph;
+    PlannerHandle handle;
+    vector<double> costs;
+    handle.setOnImprovedPath([&](const vector<State>& path, double cost)
+    {
+        // goal node first, root last
+        EXPECT_TRUE(workGraph.checkAtGoal(GraphNode(path.front(), 0, 0, 0, 0)));
+        EXPECT_EQ(path.back().distanceTo(configGraph.nodes[1]), 0);
+        costs.push_back(cost);
+    });
+    auto bestId = runEngineOnTestData(configGraph, workGraph, RrtSharpMode, 2000, NO_TIME_BUDGET, &handle);
+
+    ASSERT_TRUE(bestId);
+    ASSERT_FALSE(costs.empty());
+    for (size_t i = 1; i < costs.size(); ++i)
+        EXPECT_LT(costs[i], costs[i - 1]);
+    GTEST_ASSERT_EQ(handle.updates(), costs.size());
+    GTEST_ASSERT_EQ(handle.bestCost(), configGraph.nodes[bestId].cost());
+    for (auto& node : configGraph.nodes)
+    {
+        if (workGraph.checkAtGoal(node))
+        {
+            EXPECT_GE(node.cost(), handle.bestCost());
+        }
+    }
+}
+
+TEST(ArrtsEngine, Handle_CancelStopsAfterFirstPath)
+{
+    ConfigspaceGraph configGraph;
+    WorkspaceGraph workGraph;
+    PlannerHandle handle;
+    handle.setOnImprovedPath([&](const vector<State>&, double) { handle.cancel(); });
+    auto bestId = runEngineOnTestData(configGraph, workGraph, RrtStarMode, 2000, NO_TIME_BUDGET, &handle);
+
+    EXPECT_TRUE(bestId);
+    EXPECT_TRUE(handle.isCancelled());
+    EXPECT_LT(configGraph.nodes.size(), 2000);
+    GTEST_ASSERT_EQ(handle.updates(), 1);
+    GTEST_ASSERT_EQ(handle.bestPath().front().distanceTo(configGraph.nodes[bestId]), 0);
+}
+
+TEST(ArrtsEngine, ParallelMode_TreeStaysAcyclic)
+{
+    ConfigspaceGraph configGraph;
+    WorkspaceGraph workGraph;
+    auto bestId = runEngineOnTestData(configGraph, workGraph, RrtStarMode, 3000, NO_TIME_BUDGET, nullptr, 4);
+
+    ASSERT_TRUE(bestId);
+    expectTreeIsConsistent(configGraph);
+
+    // RRT* propagates every cost change, so costs are exact and the best goal node is the cheapest
+    for (auto& node : configGraph.nodes)
+    {
+        if (node.parentId())
+        {
+            EXPECT_NEAR(node.cost(), configGraph.nodes[node.parentId()].cost() + node.pathLength(), 1e-9);
+        }
+        if (workGraph.checkAtGoal(node))
+        {
+            EXPECT_GE(node.cost(), configGraph.nodes[bestId].cost());
+        }
+    }
+}
+
+TEST(ArrtsEngine, ParallelMode_SeededRunsMatch)
+{
+    // the batches are committed in sample order, so the thread scheduling doesn't change the tree
+    ConfigspaceGraph configGraph1, configGraph2;
+    WorkspaceGraph workGraph1, workGraph2;
+    auto bestId1 = runEngineOnTestData(configGraph1, workGraph1, RrtStarMode, 2000, NO_TIME_BUDGET, nullptr, 4, 7);
+    auto bestId2 = runEngineOnTestData(configGraph2, workGraph2, RrtStarMode, 2000, NO_TIME_BUDGET, nullptr, 4, 7);
+
+    GTEST_ASSERT_EQ(bestId1, bestId2);
+    GTEST_ASSERT_EQ(configGraph1.nodes.size(), configGraph2.nodes.size());
+    for (size_t i = 1; i < configGraph1.nodes.size(); ++i)
+    {
+        GTEST_ASSERT_EQ(configGraph1.nodes[i].parentId(), configGraph2.nodes[i].parentId());
+        GTEST_ASSERT_EQ(configGraph1.nodes[i].cost(), configGraph2.nodes[i].cost());
+    }
+}
+
+#pragma endregion //ArrtsEngine
\ No newline at end of file
@@ -153,4 +153,40 @@ TEST(ArrtsParams_Obstacles, AddFromFile_CheckVals)
     GTEST_ASSERT_EQ(obs3->radius(), 8);
 }
 
-#pragma endregion //ArrtsParams_Obstacles
\ No newline at end of file
+#pragma endregion //ArrtsParams_Obstacles
+
+#pragma region ArrtsParams_MaxSampleStep
+
+TEST(ArrtsParams_MaxSampleStep, Default_DerivedFromThinnestObstacle)
+{
+    ArrtsParams params("./test");
+    GTEST_ASSERT_EQ(params.maxSampleStep(), 16 * SAMPLE_STEP_OBSTACLE_WIDTH_RATIO);
+}
+
+TEST(ArrtsParams_MaxSampleStep, NoObstacles_FixedCount)
+{
+    ArrtsParams params(State(0, 0, 0, 0, 0), State(10, 10, 10, 0, 0), vector<Shape3d*>(), 1);
+    GTEST_ASSERT_EQ(params.maxSampleStep(), 0);
+}
+
+TEST(ArrtsParams_MaxSampleStep, SetExplicitly_OverridesDerived)
+{
+    ArrtsParams params("./test");
+    params.setMaxSampleStep(0.5);
+    GTEST_ASSERT_EQ(params.maxSampleStep(), 0.5);
+}
+
+#pragma endregion //ArrtsParams_MaxSampleStep
+
+#pragma region ArrtsParams_NumThreads
+
+TEST(ArrtsParams_NumThreads, Default_ExpandsSerially)
+{
+    // batched expansion has no multi-core measurements behind it yet, so it stays opt-in
+    ArrtsParams params("./test");
+    GTEST_ASSERT_EQ(params.numThreads(), 1);
+    params.setNumThreads(4);
+    GTEST_ASSERT_EQ(params.numThreads(), 4);
+}
+
+#pragma endregion //ArrtsParams_NumThreads
\ No newline at end of file
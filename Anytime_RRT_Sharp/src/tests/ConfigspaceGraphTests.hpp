@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "../ConfigspaceGraph.hpp"
+
+#pragma region ConfigspaceGraph
+
+ConfigspaceGraph buildRandomTestGraph(int numNodes, NodeIndexType indexType)
+{
+    ConfigspaceGraph graph;
+    graph.setNodeIndexType(indexType);
+    graph.defineFreespace(Rectangle(0, 0, 0, 100, 100, 100), 3, 0);
+    graph.setRootNode(State(50, 50, 50, 0, 0));
+    for (int i = 1; i < numNodes; ++i)
+        graph.addNode(graph.generateRandomNode());
+    return graph;
+}
+
+TEST(ConfigspaceGraph, FindClosestParentIds_MatchesSingleQueries)
+{
+    ManeuverEngine::maneuverType = DirectPath;
+    for (NodeIndexType indexType : { KdTreeIndex, SpatialHashIndex, PositionStoreIndex })
+    {
+        srand(21);
+        ConfigspaceGraph graph = buildRandomTestGraph(2000, indexType);
+        vector<ConfigspaceNode> samples(500);
+        for (auto& sample : samples)
+            sample = graph.generateRandomNode();
+
+        for (int numThreads : { 1, 4 })
+        {
+            auto parentIds = graph.findClosestParentIds(samples, numThreads);
+            GTEST_ASSERT_EQ(parentIds.size(), samples.size());
+            for (int i = 0; i < samples.size(); ++i)
+                GTEST_ASSERT_EQ(parentIds[i], graph.findClosestParentNode(samples[i]).id());
+        }
+    }
+}
+
+TEST(ConfigspaceGraph, FindNeighborhoods_MatchesSingleQueries)
+{
+    ManeuverEngine::maneuverType = DirectPath;
+    srand(22);
+    ConfigspaceGraph graph = buildRandomTestGraph(3000, KdTreeIndex);
+    vector<ConfigspaceNode> samples(400);
+    for (auto& sample : samples)
+        sample = graph.generateRandomNode();
+
+    auto neighborhoods = graph.findNeighborhoods(samples, 50, 10, 4);
+    GTEST_ASSERT_EQ(neighborhoods.size(), samples.size());
+    for (int i = 0; i < samples.size(); ++i)
+    {
+        samples[i].setParentId(graph.findClosestParentNode(samples[i]).id());
+        GTEST_ASSERT_EQ(neighborhoods[i].parentId, samples[i].parentId());
+
+        auto neighbors = graph.findNeighbors(samples[i], 50, 10);
+        GTEST_ASSERT_EQ(neighborhoods[i].neighborIds.size(), neighbors.size());
+        for (int j = 0; j < neighbors.size(); ++j)
+            GTEST_ASSERT_EQ(neighborhoods[i].neighborIds[j], neighbors[j].id());
+    }
+
+    auto neighborIds = graph.findNeighborIds(samples, 50, 10, 3);
+    for (int i = 0; i < samples.size(); ++i)
+        EXPECT_EQ(neighborIds[i], neighborhoods[i].neighborIds);
+}
+
+TEST(ConfigspaceGraph, BatchQueries_EmptyBatch)
+{
+    srand(23);
+    ConfigspaceGraph graph = buildRandomTestGraph(10, KdTreeIndex);
+    vector<ConfigspaceNode> samples;
+    GTEST_ASSERT_EQ(graph.findClosestParentIds(samples, 0).size(), 0);
+    GTEST_ASSERT_EQ(graph.findNeighborhoods(samples, 50, 10, 0).size(), 0);
+}
+
+// a tree where each node hangs off a random earlier one, or off the previous one for a chain;
+// path lengths are straight line distances and costs are consistent
+ConfigspaceGraph buildTestTree(int numNodes, bool chain)
+{
+    ConfigspaceGraph graph;
+    graph.setNodeIndexType(PositionStoreIndex);
+    graph.defineFreespace(Rectangle(0, 0, 0, 100, 100, 100), 3, 0);
+    graph.setRootNode(State(50, 50, 50, 0, 0));
+    for (int i = 1; i < numNodes; ++i)
+    {
+        auto& parent = graph.nodes[chain ? i : 1 + rand() % i];
+        auto node = graph.generateRandomNode();
+        node.setParentId(parent.id());
+        node.setPathLength(node.distanceTo(parent));
+        node.setCost(parent.cost() + node.pathLength());
+        graph.addNode(node);
+    }
+    return graph;
+}
+
+void expectConsistentCosts(ConfigspaceGraph& graph)
+{
+    for (auto& node : graph.nodes)
+    {
+        if (!node.parentId())
+            continue;
+        GTEST_ASSERT_EQ(node.cost(), graph.nodes[node.parentId()].cost() + node.pathLength());
+
+        int numListed = 0;
+        for (auto id = graph.firstChildId(node.parentId()); id; id = graph.nextSiblingId(id))
+            numListed += id == node.id();
+        GTEST_ASSERT_EQ(numListed, 1);
+    }
+}
+
+TEST(ConfigspaceGraph, PropagateCost_RewiredSubtreeUpdatedInPlace)
+{
+    srand(21);
+    auto graph = buildTestTree(2000, false);
+
+    // rewire nodes that have children to the root, as a rewire would after finding a shortcut
+    for (unsigned long id = 2; id < 200; ++id)
+    {
+        if (!graph.firstChildId(id))
+            continue;
+
+        auto root = graph.nodes[1];
+        auto rewired = graph.nodes[id];
+        rewired.setParentId(root.id());
+        rewired.setPathLength(rewired.distanceTo(root));
+        rewired.setCost(root.cost() + rewired.pathLength());
+        graph.replaceNode(graph.nodes[id], rewired);
+        graph.propagateCost(id);
+    }
+
+    expectConsistentCosts(graph);
+}
+
+TEST(ConfigspaceGraph, PropagateCost_DeepChain)
+{
+    srand(21);
+    int numNodes = 200000;
+    auto graph = buildTestTree(numNodes, true);
+
+    graph.nodes[1].setCost(-10);
+    double leafCost = graph.nodes[numNodes].cost();
+    graph.propagateCost(1);
+
+    GTEST_ASSERT_LT(graph.nodes[numNodes].cost(), leafCost - 9);
+    expectConsistentCosts(graph);
+}
+
+TEST(ConfigspaceGraph, GoalNodes_FollowRewiresAndPropagation)
+{
+    srand(22);
+    auto graph = buildTestTree(2000, false);
+    graph.setGoalRegion(State(90, 90, 90, 0, 0), 20);
+    ASSERT_GT(graph.goalNodes().size(), 1);
+
+    // rewire every node directly to the root, then check the best goal node against a scan
+    for (unsigned long id = 2; id <= 2000; ++id)
+    {
+        auto root = graph.nodes[1];
+        auto rewired = graph.nodes[id];
+        rewired.setParentId(root.id());
+        rewired.setPathLength(rewired.distanceTo(root));
+        rewired.setCost(root.cost() + rewired.pathLength());
+        graph.replaceNode(graph.nodes[id], rewired);
+        graph.propagateCost(id);
+
+        double bestCost = INFINITY;
+        for (auto& node : graph.nodes)
+            if (graph.goalNodes().contains(node.id()))
+                bestCost = min(bestCost, node.cost());
+        GTEST_ASSERT_EQ(graph.goalNodes().bestCost(), bestCost);
+        GTEST_ASSERT_EQ(graph.nodes[graph.goalNodes().bestId()].cost(), bestCost);
+    }
+}
+
+#pragma endregion //ConfigspaceGraph
\ No newline at end of file
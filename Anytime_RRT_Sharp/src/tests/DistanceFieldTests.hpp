@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include "../ArrtsService.hpp"
+#include "../DistanceField.hpp"
+#include "../ObstacleBvh.hpp"
+#include "../WorkspaceGraph.hpp"
+
+#pragma region DistanceField
+
+TEST(DistanceField, Lookup_BoundsExactDistance)
+{
+    srand(17);
+    auto obstacles = buildRandomObstacles(200);
+    ObstacleBvh bvh(obstacles);
+    DistanceField field;
+    field.build(Rectangle(0, 0, 0, 100, 100, 100), bvh, 2.0);
+    GTEST_ASSERT_EQ(field.size(), 51 * 51 * 51);
+
+    double lower, upper;
+    EXPECT_FALSE(field.lookup(Point(-1, 50, 50), lower, upper));
+    for (int i = 0; i < 2000; ++i)
+    {
+        Point p(rand() % 1000 / 10.0, rand() % 1000 / 10.0, rand() % 1000 / 10.0);
+        double exact = bvh.signedDistance(p);
+        ASSERT_TRUE(field.lookup(p, lower, upper));
+        GTEST_ASSERT_LE(lower, exact);
+        GTEST_ASSERT_GE(upper, exact);
+    }
+
+    for (auto o : obstacles)
+        delete o;
+}
+
+TEST(DistanceField, ParallelBuild_MatchesSingleThread)
+{
+    srand(17);
+    auto obstacles = buildRandomObstacles(100);
+    ObstacleBvh bvh(obstacles);
+    DistanceField serial, parallel;
+    serial.build(Rectangle(0, 0, 0, 50, 60, 70), bvh, 1.5, 1);
+    parallel.build(Rectangle(0, 0, 0, 50, 60, 70), bvh, 1.5, 4);
+
+    double serialLower, serialUpper, parallelLower, parallelUpper;
+    for (int i = 0; i < 1000; ++i)
+    {
+        Point p(rand() % 500 / 10.0, rand() % 600 / 10.0, rand() % 700 / 10.0);
+        serial.lookup(p, serialLower, serialUpper);
+        parallel.lookup(p, parallelLower, parallelUpper);
+        GTEST_ASSERT_EQ(serialLower, parallelLower);
+    }
+
+    for (auto o : obstacles)
+        delete o;
+}
+
+TEST(DistanceField, SaveAndLoad_RoundTrip)
+{
+    vector<Shape3d*> obstacles = { new Sphere(10, 10, 10, 3), new Rectangle(20, 0, 0, 25, 30, 30) };
+    ObstacleBvh bvh(obstacles);
+    Rectangle limits(0, 0, 0, 30, 30, 30);
+    DistanceField saved, loaded;
+    saved.build(limits, bvh, 1.0);
+
+    string fileName = "distance_field_test.bin";
+    saved.save(fileName);
+    loaded.load(fileName);
+    remove(fileName.c_str());
+
+    ASSERT_TRUE(loaded.covers(limits, 1.0, DistanceField::fingerprint(obstacles)));
+    EXPECT_FALSE(loaded.covers(limits, 2.0, DistanceField::fingerprint(obstacles)));
+    GTEST_ASSERT_EQ(loaded.size(), saved.size());
+
+    double savedLower, savedUpper, loadedLower, loadedUpper;
+    saved.lookup(Point(12.3, 4.5, 6.7), savedLower, savedUpper);
+    loaded.lookup(Point(12.3, 4.5, 6.7), loadedLower, loadedUpper);
+    GTEST_ASSERT_EQ(savedLower, loadedLower);
+
+    EXPECT_THROW(loaded.load("./test/obstacles.txt"), runtime_error);
+    for (auto o : obstacles)
+        delete o;
+}
+
+TEST(DistanceField, Fingerprint_ChangesWithAnyObstacle)
+{
+    vector<Shape3d*> obstacles = { new Sphere(10, 10, 10, 3), new Rectangle(20, 0, 0, 25, 30, 30) };
+    vector<Shape3d*> reordered = { obstacles[1], obstacles[0] };
+    vector<Shape3d*> moved = { new Sphere(10, 10, 11, 3), obstacles[1] };
+    vector<Shape3d*> added = { obstacles[0], obstacles[1], moved[0] };
+
+    auto fingerprint = DistanceField::fingerprint(obstacles);
+    GTEST_ASSERT_EQ(DistanceField::fingerprint(reordered), fingerprint);
+    EXPECT_NE(DistanceField::fingerprint(moved), fingerprint);
+    EXPECT_NE(DistanceField::fingerprint(added), fingerprint);
+
+    ObstacleBvh bvh(obstacles);
+    DistanceField field;
+    Rectangle limits(0, 0, 0, 30, 30, 30);
+    field.build(limits, bvh, 1.0);
+    GTEST_ASSERT_EQ(field.obstacleFingerprint(), fingerprint);
+    EXPECT_FALSE(field.covers(limits, 1.0, DistanceField::fingerprint(moved)));
+
+    for (auto o : added)
+        delete o;
+}
+
+TEST(DistanceField, Service_RebuildsStaleOrCorruptFile)
+{
+    // plans with the first obstacle shifted along x; the field in use always has to come from
+    // the obstacles being planned around, whether it was loaded or built
+    string fileName = "distance_field_service_test.bin";
+    auto planWithField = [&](double shift) {
+        ArrtsParams params("./test", 200);
+        params.setDistanceFieldResolution(2.0);
+        params.setDistanceFieldFile(fileName);
+        auto& obstacles = params.obstacles();
+        auto sphere = dynamic_cast<Sphere*>(obstacles[0]);
+        obstacles[0] = new Sphere(sphere->x() + shift, sphere->y(), sphere->z(), sphere->radius());
+
+        ArrtsService service;
+        service.calculatePath(params, "", DirectPath);
+        auto& workGraph = service.workspaceGraph();
+        EXPECT_EQ(workGraph.distanceField().obstacleFingerprint(), workGraph.obstacleFingerprint());
+        return workGraph.obstacleFingerprint();
+    };
+
+    remove(fileName.c_str());
+    auto fingerprint = planWithField(0);
+    auto movedFingerprint = planWithField(5);
+    EXPECT_NE(movedFingerprint, fingerprint);
+
+    // the moved obstacle's field replaced the stale one in the file
+    DistanceField saved;
+    saved.load(fileName);
+    GTEST_ASSERT_EQ(saved.obstacleFingerprint(), movedFingerprint);
+
+    // a truncated file is rebuilt instead of stopping the planner
+    ofstream(fileName, ios::binary) << "ASDF";
+    EXPECT_NO_THROW(planWithField(0));
+    saved.load(fileName);
+    GTEST_ASSERT_EQ(saved.obstacleFingerprint(), fingerprint);
+    remove(fileName.c_str());
+}
+
+TEST(DistanceField, WorkspaceChecks_MatchWithoutField)
+{
+    srand(17);
+    auto obstacles = buildRandomObstacles(300);
+    WorkspaceGraph exact, traced;
+    for (auto workGraph : { &exact, &traced })
+    {
+        workGraph->defineFreespace(Rectangle(0, 0, 0, 100, 100, 100));
+        workGraph->addObstacles(obstacles);
+    }
+    traced.buildDistanceField(1.0);
+    ASSERT_TRUE(traced.hasDistanceField());
+    ManeuverEngine::maneuverType = DirectPath;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        Point p1(rand() % 1000 / 10.0, rand() % 1000 / 10.0, rand() % 1000 / 10.0);
+        Point p2(p1.x() + rand() % 300 / 10.0 - 15, p1.y() + rand() % 300 / 10.0 - 15, p1.z() + rand() % 100 / 10.0 - 5);
+        double radius = rand() % 20 / 10.0;
+        auto path = ManeuverEngine::generatePath(State(p1, 0, 0), State(p2, 0, 0));
+
+        GTEST_ASSERT_EQ(traced.nodeIsSafe(p1), exact.nodeIsSafe(p1));
+        GTEST_ASSERT_EQ(traced.segmentIsSafe(p1, p2), exact.segmentIsSafe(p1, p2));
+        GTEST_ASSERT_EQ(traced.capsuleIsSafe(p1, p2, radius), exact.capsuleIsSafe(p1, p2, radius));
+        GTEST_ASSERT_EQ(traced.pathIsSafe(path), exact.pathIsSafe(path));
+    }
+
+    // sampled paths skip the samples that lie within the clearance of a checked one
+    GTEST_ASSERT_LT(traced.samplesChecked(), exact.samplesChecked());
+
+    traced.addObstacle(50, 50, 50, 1);
+    EXPECT_FALSE(traced.hasDistanceField());
+    for (auto o : obstacles)
+        delete o;
+}
+
+#pragma endregion //DistanceField
\ No newline at end of file
@@ -93,6 +93,45 @@ TEST(Sphere, LineIntersect_DoesNotIntersect_Reverse)
     EXPECT_FALSE(so.intersects(l));
 }
 
+TEST(Sphere, LineIntersect_SegmentStopsShort)
+{
+    Sphere so(10, 0, 0, 2);
+    Point p1(0, 0, 0), p2(7.9, 0, 0);
+    Line l(p1, p2);
+    EXPECT_FALSE(so.intersects(l));
+}
+
+TEST(Sphere, LineIntersect_PassesThroughWithoutEndpointsInside)
+{
+    Sphere so(5, 0.5, 0, 1);
+    Point p1(0, 0, 0), p2(10, 0, 0);
+    Line l(p1, p2);
+    EXPECT_TRUE(so.intersects(l));
+}
+
+TEST(Sphere, LineIntersect_ZeroLength)
+{
+    Sphere so(1, 1, 1, 5);
+    Point p1(2, 2, 2), p2(9, 9, 9);
+    EXPECT_TRUE(so.intersects(Line(p1, p1)));
+    EXPECT_FALSE(so.intersects(Line(p2, p2)));
+}
+
+TEST(Sphere, CapsuleIntersect_WithinRadius)
+{
+    Sphere so(5, 3, 0, 1);
+    Line l(Point(0, 0, 0), Point(10, 0, 0));
+    EXPECT_TRUE(so.intersectsCapsule(l, 2.5));
+    EXPECT_FALSE(so.intersectsCapsule(l, 1.5));
+}
+
+TEST(Sphere, SignedDistance_OutsideAndInside)
+{
+    Sphere so(1, 1, 1, 2);
+    EXPECT_DOUBLE_EQ(so.signedDistance(Point(1, 1, 6)), 3);
+    EXPECT_DOUBLE_EQ(so.signedDistance(Point(1, 1, 1)), -2);
+}
+
 TEST(Sphere, RectagleIntersect_FullyContained)
 {
     Sphere so(3, 3, 3, 1);
@@ -337,6 +376,43 @@ TEST(Rectangle, LineIntersect_DoesNotIntersect_TwoPoints_Reverse)
     EXPECT_FALSE(ro.intersects(l));
 }
 
+TEST(Rectangle, LineIntersect_PassesThroughWithoutEndpointsInside)
+{
+    Rectangle ro(Point(4, -1, -1), Point(5, 1, 1));
+    Line l(Point(0, 0, 0), Point(10, 0.5, 0));
+    EXPECT_TRUE(ro.intersects(l));
+}
+
+TEST(Rectangle, LineIntersect_ParallelToFace_Outside)
+{
+    Rectangle ro(Point(1, 1, 1), Point(5, 5, 5));
+    Line l(Point(0, 6, 2), Point(10, 6, 2));
+    EXPECT_FALSE(ro.intersects(l));
+}
+
+TEST(Rectangle, LineIntersect_MissesCorner)
+{
+    Rectangle ro(Point(1, 1, 1), Point(5, 5, 5));
+    Line l(Point(0, 1.5, 3), Point(1.5, 0, 3));
+    EXPECT_FALSE(ro.intersects(l));
+}
+
+TEST(Rectangle, CapsuleIntersect_WithinRadius)
+{
+    Rectangle ro(Point(4, 2, -1), Point(6, 4, 1));
+    Line l(Point(0, 0, 0), Point(10, 0, 0));
+    EXPECT_TRUE(ro.intersectsCapsule(l, 2.5));
+    EXPECT_FALSE(ro.intersectsCapsule(l, 1.5));
+}
+
+TEST(Rectangle, SignedDistance_FaceCornerAndInside)
+{
+    Rectangle ro(Point(0, 0, 0), Point(4, 4, 4));
+    EXPECT_DOUBLE_EQ(ro.signedDistance(Point(2, 2, 7)), 3);
+    EXPECT_DOUBLE_EQ(ro.signedDistance(Point(5, 6, 4)), sqrt(5.0));
+    EXPECT_DOUBLE_EQ(ro.signedDistance(Point(1, 2, 2)), -1);
+}
+
 TEST(Rectangle, RectagleIntersect_FullyContained)
 {
     Rectangle ro(Point(1, 1, 1), Point(2, 2, 2));
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include "../GoalNodeSet.hpp"
+
+#pragma region GoalNodeSet
+
+TEST(GoalNodeSet, Empty_CheckVals)
+{
+    GoalNodeSet goalNodes;
+    GTEST_ASSERT_EQ(goalNodes.size(), 0);
+    GTEST_ASSERT_EQ(goalNodes.bestId(), 0);
+    EXPECT_TRUE(isinf(goalNodes.bestCost()));
+
+    // without a goal nothing is in the region
+    goalNodes.insert(ConfigspaceNode(0, 0, 0, 0, 0, 1, 0, 0));
+    GTEST_ASSERT_EQ(goalNodes.size(), 0);
+}
+
+TEST(GoalNodeSet, Insert_OnlyNodesInRegion)
+{
+    GoalNodeSet goalNodes;
+    goalNodes.setGoal(State(10, 0, 0, 0, 0), 2);
+    goalNodes.insert(ConfigspaceNode(9, 0, 0, 0, 0, 1, 0, 5));
+    goalNodes.insert(ConfigspaceNode(0, 0, 0, 0, 0, 2, 0, 1));
+    goalNodes.insert(ConfigspaceNode(10, 1, 0, 0, 0, 3, 0, 4));
+
+    GTEST_ASSERT_EQ(goalNodes.size(), 2);
+    EXPECT_FALSE(goalNodes.contains(2));
+    GTEST_ASSERT_EQ(goalNodes.bestId(), 3);
+    GTEST_ASSERT_EQ(goalNodes.bestCost(), 4);
+}
+
+TEST(GoalNodeSet, UpdateCost_BestFollowsCost)
+{
+    GoalNodeSet goalNodes;
+    goalNodes.setGoal(State(0, 0, 0, 0, 0), 1);
+    for (unsigned long id = 1; id <= 3; ++id)
+        goalNodes.insert(ConfigspaceNode(0, 0, 0, 0, 0, id, 0, 10.0 * id));
+
+    goalNodes.updateCost(3, 5);
+    GTEST_ASSERT_EQ(goalNodes.bestId(), 3);
+
+    // costs may go up as well
+    goalNodes.updateCost(3, 50);
+    GTEST_ASSERT_EQ(goalNodes.bestId(), 1);
+
+    goalNodes.erase(1);
+    GTEST_ASSERT_EQ(goalNodes.bestId(), 2);
+    GTEST_ASSERT_EQ(goalNodes.size(), 2);
+
+    goalNodes.updateCost(1, 0);
+    GTEST_ASSERT_EQ(goalNodes.bestId(), 2);
+}
+
+#pragma endregion //GoalNodeSet
\ No newline at end of file
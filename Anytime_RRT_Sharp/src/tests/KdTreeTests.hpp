@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include "../KdTree.hpp"
+
+#pragma region KdTree
+
+unsigned long findNearestByScan(const vector<Point>& points, const Point& p)
+{
+    double dist, shortestDist = INFINITY;
+    unsigned long closestId = 0;
+    for (int i = 0; i < points.size(); ++i)
+    {
+        dist = points[i].distanceTo(p);
+        if (dist < shortestDist)
+        {
+            shortestDist = dist;
+            closestId = i + 1;
+        }
+    }
+    return closestId;
+}
+
+vector<Point> generateRandomPoints(int num)
+{
+    vector<Point> points(num);
+    for (auto& p : points)
+        p = Point(rand() % 1000 / 10.0, rand() % 1000 / 10.0, rand() % 1000 / 10.0);
+    return points;
+}
+
+TEST(KdTree, Empty_FindNearest_ReturnsZero)
+{
+    KdTree tree;
+    GTEST_ASSERT_EQ(tree.size(), 0);
+    GTEST_ASSERT_EQ(tree.findNearest(Point(1, 2, 3)), 0);
+}
+
+TEST(KdTree, InsertOne_FindNearest)
+{
+    KdTree tree;
+    tree.insert(1, Point(1, 2, 3));
+    GTEST_ASSERT_EQ(tree.size(), 1);
+    GTEST_ASSERT_EQ(tree.findNearest(Point(100, -50, 3)), 1);
+}
+
+TEST(KdTree, InsertMany_FindNearest_MatchesScan)
+{
+    srand(7);
+    KdTree tree;
+    auto points = generateRandomPoints(2000);
+    for (int i = 0; i < points.size(); ++i)
+        tree.insert(i + 1, points[i]);
+
+    for (auto& q : generateRandomPoints(200))
+    {
+        unsigned long id = tree.findNearest(q);
+        EXPECT_DOUBLE_EQ(points[id - 1].distanceTo(q), points[findNearestByScan(points, q) - 1].distanceTo(q));
+    }
+}
+
+TEST(KdTree, SortedInsertion_StaysBalanced)
+{
+    KdTree tree;
+    for (int i = 1; i <= 4096; ++i)
+        tree.insert(i, Point(i, i, i));
+
+    EXPECT_LE(tree.depth(), KD_TREE_REBALANCE_FACTOR * 13);
+    GTEST_ASSERT_EQ(tree.findNearest(Point(100.2, 100.2, 100.2)), 100);
+}
+
+TEST(KdTree, Remove_NotReturned)
+{
+    KdTree tree;
+    tree.insert(1, Point(0, 0, 0));
+    tree.insert(2, Point(10, 10, 10));
+    tree.remove(1);
+
+    EXPECT_FALSE(tree.contains(1));
+    GTEST_ASSERT_EQ(tree.size(), 1);
+    GTEST_ASSERT_EQ(tree.findNearest(Point(0, 0, 0)), 2);
+}
+
+TEST(KdTree, Update_MovesNode)
+{
+    KdTree tree;
+    tree.insert(1, Point(0, 0, 0));
+    tree.insert(2, Point(10, 10, 10));
+    tree.update(1, Point(20, 20, 20));
+
+    GTEST_ASSERT_EQ(tree.size(), 2);
+    GTEST_ASSERT_EQ(tree.findNearest(Point(21, 21, 21)), 1);
+    GTEST_ASSERT_EQ(tree.findNearest(Point(0, 0, 0)), 2);
+}
+
+TEST(KdTree, FindKNearest_SortedAndMatchesScan)
+{
+    srand(11);
+    KdTree tree;
+    auto points = generateRandomPoints(2000);
+    for (int i = 0; i < points.size(); ++i)
+        tree.insert(i + 1, points[i]);
+
+    Point q(50, 50, 50);
+    vector<double> scanDists;
+    for (auto& p : points)
+        if (p.distanceTo(q) < 20)
+            scanDists.push_back(p.distanceTo(q));
+    sort(scanDists.begin(), scanDists.end());
+
+    auto ids = tree.findNearest(q, 15, 20);
+    GTEST_ASSERT_EQ(ids.size(), min((int)scanDists.size(), 15));
+    for (int i = 0; i < ids.size(); ++i)
+        EXPECT_DOUBLE_EQ(points[ids[i] - 1].distanceTo(q), scanDists[i]);
+}
+
+TEST(KdTree, FindKNearest_RespectsRadius)
+{
+    KdTree tree;
+    tree.insert(1, Point(0, 0, 0));
+    tree.insert(2, Point(1, 0, 0));
+    tree.insert(3, Point(2, 0, 0));
+    tree.insert(4, Point(5, 0, 0));
+
+    auto ids = tree.findNearest(Point(0, 0, 0), 10, 2);
+    GTEST_ASSERT_EQ(ids.size(), 2);
+    GTEST_ASSERT_EQ(ids[0], 1);
+    GTEST_ASSERT_EQ(ids[1], 2);
+}
+
+TEST(KdTree, FindKNearest_SkipsRemoved)
+{
+    KdTree tree;
+    tree.insert(1, Point(0, 0, 0));
+    tree.insert(2, Point(1, 0, 0));
+    tree.insert(3, Point(2, 0, 0));
+    tree.remove(2);
+
+    auto ids = tree.findNearest(Point(0, 0, 0), 2, 10);
+    GTEST_ASSERT_EQ(ids.size(), 2);
+    GTEST_ASSERT_EQ(ids[0], 1);
+    GTEST_ASSERT_EQ(ids[1], 3);
+}
+
+TEST(KdTree, Approximate_WithinErrorBound)
+{
+    srand(31);
+    double epsilon = 0.5;
+    KdTree tree;
+    auto points = generateRandomPoints(3000);
+    for (int i = 0; i < points.size(); ++i)
+        tree.insert(i + 1, points[i]);
+    tree.setApproximationError(epsilon);
+
+    for (auto& q : generateRandomPoints(200))
+    {
+        double exactDist = points[findNearestByScan(points, q) - 1].distanceTo(q);
+        EXPECT_LE(points[tree.findNearest(q) - 1].distanceTo(q), (1 + epsilon) * exactDist + 1e-9);
+    }
+
+    auto stats = tree.approximateQueryStats();
+    GTEST_ASSERT_EQ(stats.queries, 200);
+    GTEST_ASSERT_EQ(stats.audited, 200 / KD_TREE_APPROXIMATION_AUDIT_INTERVAL + 1);
+    EXPECT_LE(stats.inexact, stats.audited);
+}
+
+TEST(KdTree, Approximate_ZeroErrorIsExact)
+{
+    srand(32);
+    KdTree tree;
+    auto points = generateRandomPoints(1000);
+    for (int i = 0; i < points.size(); ++i)
+        tree.insert(i + 1, points[i]);
+    tree.setApproximationError(0);
+
+    for (auto& q : generateRandomPoints(50))
+        EXPECT_DOUBLE_EQ(points[tree.findNearest(q) - 1].distanceTo(q), points[findNearestByScan(points, q) - 1].distanceTo(q));
+    GTEST_ASSERT_EQ(tree.approximateQueryStats().queries, 0);
+}
+
+#pragma endregion //KdTree
\ No newline at end of file
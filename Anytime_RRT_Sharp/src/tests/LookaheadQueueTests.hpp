@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "../LookaheadQueue.hpp"
+
+#pragma region LookaheadQueue
+
+GraphNode buildQueueNode(unsigned long id, double x)
+{
+    return GraphNode(x, 0, 0, 0, 0, id, 0);
+}
+
+TEST(LookaheadQueue, Empty_CheckVals)
+{
+    LookaheadQueue queue;
+    EXPECT_TRUE(queue.empty());
+    GTEST_ASSERT_EQ(queue.pop(), 0);
+    EXPECT_TRUE(isinf(queue.topKey()));
+    EXPECT_TRUE(isinf(queue.lookahead(5).cost));
+}
+
+TEST(LookaheadQueue, Relax_OnlyLowers)
+{
+    LookaheadQueue queue;
+    EXPECT_TRUE(queue.relax(3, 10, 1, 4));
+    EXPECT_FALSE(queue.relax(3, 12, 2, 5));
+    EXPECT_TRUE(queue.relax(3, 8, 2, 5));
+
+    GTEST_ASSERT_EQ(queue.lookahead(3).cost, 8);
+    GTEST_ASSERT_EQ(queue.lookahead(3).parentId, 2);
+    GTEST_ASSERT_EQ(queue.lookahead(3).pathLength, 5);
+}
+
+TEST(LookaheadQueue, Pop_OrderedByCostPlusHeuristic)
+{
+    // the goal is at x = 10 with a tolerance of 1
+    LookaheadQueue queue;
+    queue.setGoal(State(10, 0, 0, 0, 0), 1);
+    queue.relax(1, 2, 0, 0);
+    queue.relax(2, 5, 0, 0);
+    queue.relax(3, 4, 0, 0);
+    queue.push(buildQueueNode(1, 0));   // 2 + 9
+    queue.push(buildQueueNode(2, 8));   // 5 + 1
+    queue.push(buildQueueNode(3, 10));  // 4 + 0
+
+    GTEST_ASSERT_EQ(queue.size(), 3);
+    GTEST_ASSERT_EQ(queue.topKey(), 4);
+    GTEST_ASSERT_EQ(queue.pop(), 3);
+    GTEST_ASSERT_EQ(queue.pop(), 2);
+    GTEST_ASSERT_EQ(queue.pop(), 1);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(LookaheadQueue, Push_RequeuedNodeSkipsOldEntry)
+{
+    LookaheadQueue queue;
+    queue.relax(1, 5, 0, 0);
+    queue.relax(2, 3, 0, 0);
+    queue.push(buildQueueNode(1, 0));
+    queue.push(buildQueueNode(2, 0));
+
+    queue.relax(1, 1, 0, 0);
+    queue.push(buildQueueNode(1, 0));
+
+    GTEST_ASSERT_EQ(queue.size(), 2);
+    GTEST_ASSERT_EQ(queue.pop(), 1);
+    EXPECT_FALSE(queue.isQueued(1));
+    GTEST_ASSERT_EQ(queue.pop(), 2);
+    GTEST_ASSERT_EQ(queue.pop(), 0);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(LookaheadQueue, Replan_StopsAtGoalCost)
+{
+    // the goal is at x = 10 with a tolerance of 1 and the best goal node costs 8
+    LookaheadQueue queue;
+    queue.setGoal(State(10, 0, 0, 0, 0), 1);
+    double goalCost = 8;
+    queue.relax(1, 1, 0, 0);
+    queue.relax(2, 3, 0, 0);
+    queue.relax(3, 5, 0, 0);
+    queue.push(buildQueueNode(1, 9));   // 1 + 0
+    queue.push(buildQueueNode(2, 0));   // 3 + 9
+    queue.push(buildQueueNode(3, 5));   // 5 + 4
+
+    // requeuing node 3 at 2 + 4 leaves a stale entry at 9 behind; a higher cost changes nothing
+    EXPECT_TRUE(queue.relax(3, 2, 1, 1));
+    queue.push(buildQueueNode(3, 5));
+    EXPECT_FALSE(queue.relax(2, 4, 1, 1));
+    GTEST_ASSERT_EQ(queue.size(), 3);
+
+    // expand the way RRT# replans; the stale entry must not count as a promising node
+    vector<unsigned long> expanded;
+    while (queue.topKey() < goalCost)
+        expanded.push_back(queue.pop());
+
+    GTEST_ASSERT_EQ(expanded.size(), 2);
+    GTEST_ASSERT_EQ(expanded[0], 1);
+    GTEST_ASSERT_EQ(expanded[1], 3);
+    GTEST_ASSERT_EQ(queue.topKey(), 12);
+    EXPECT_TRUE(queue.isQueued(2));
+    EXPECT_FALSE(queue.isQueued(3));
+    GTEST_ASSERT_EQ(queue.size(), 1);
+}
+
+#pragma endregion //LookaheadQueue
\ No newline at end of file
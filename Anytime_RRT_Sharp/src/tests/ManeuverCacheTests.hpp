@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "../ManeuverCache.hpp"
+
+#pragma region ManeuverCache
+
+TEST(ManeuverCache, Miss_ThenHit)
+{
+    ManeuverCache cache;
+    State start(1, 2, 3, 0.5, 0.1), final(4, 5, 6, 1.5, -0.1);
+    double length = 0;
+
+    EXPECT_FALSE(cache.findLength(start, final, length));
+    cache.insert(start, final, 12.5);
+    EXPECT_TRUE(cache.findLength(start, final, length));
+    GTEST_ASSERT_EQ(length, 12.5);
+
+    auto stats = cache.stats();
+    GTEST_ASSERT_EQ(stats.hits, 1);
+    GTEST_ASSERT_EQ(stats.misses, 1);
+    GTEST_ASSERT_EQ(stats.entries, 1);
+}
+
+TEST(ManeuverCache, KeysAreDirected)
+{
+    ManeuverCache cache;
+    State a(1, 2, 3, 0.5, 0.1), b(4, 5, 6, 1.5, -0.1);
+    double length = 0;
+
+    cache.insert(a, b, 7);
+    EXPECT_FALSE(cache.findLength(b, a, length));
+    GTEST_ASSERT_NE(maneuver_key_hash()(ManeuverKey(a, b)), maneuver_key_hash()(ManeuverKey(b, a)));
+}
+
+TEST(ManeuverCache, LengthOnlyEntry_MissesPath)
+{
+    ManeuverCache cache;
+    State start(0, 0, 0, 0, 0), final(10, 0, 0, 0, 0);
+    vector<State> path;
+
+    cache.insert(start, final, 10);
+    EXPECT_FALSE(cache.findPath(start, final, path));
+
+    cache.insert(start, final, 10, { start, final });
+    EXPECT_TRUE(cache.findPath(start, final, path));
+    GTEST_ASSERT_EQ(path.size(), 2);
+    GTEST_ASSERT_EQ(path[1].x(), 10);
+}
+
+TEST(ManeuverCache, Capacity_EvictsLeastRecentlyUsed)
+{
+    ManeuverCache cache;
+    State origin(0, 0, 0, 0, 0);
+    cache.insert(origin, State(1, 0, 0, 0, 0), 1);
+    unsigned long entryBytes = cache.stats().bytes;
+    cache.setCapacity(3 * entryBytes);
+
+    cache.insert(origin, State(2, 0, 0, 0, 0), 2);
+    cache.insert(origin, State(3, 0, 0, 0, 0), 3);
+
+    // touching the first entry makes the second the least recently used
+    double length;
+    EXPECT_TRUE(cache.findLength(origin, State(1, 0, 0, 0, 0), length));
+    cache.insert(origin, State(4, 0, 0, 0, 0), 4);
+
+    auto stats = cache.stats();
+    GTEST_ASSERT_EQ(stats.evictions, 1);
+    GTEST_ASSERT_EQ(stats.entries, 3);
+    EXPECT_LE(stats.bytes, cache.capacity());
+    EXPECT_TRUE(cache.findLength(origin, State(1, 0, 0, 0, 0), length));
+    EXPECT_FALSE(cache.findLength(origin, State(2, 0, 0, 0, 0), length));
+}
+
+TEST(ManeuverCache, ZeroCapacity_StoresNothing)
+{
+    ManeuverCache cache(0);
+    State start(0, 0, 0, 0, 0), final(10, 0, 0, 0, 0);
+    double length;
+
+    cache.insert(start, final, 10);
+    EXPECT_FALSE(cache.findLength(start, final, length));
+    GTEST_ASSERT_EQ(cache.stats().entries, 0);
+}
+
+#pragma endregion //ManeuverCache
\ No newline at end of file
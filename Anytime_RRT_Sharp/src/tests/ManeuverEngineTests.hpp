@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include "../Geometry3D.hpp"
 #include "../ManeuverEngine.hpp"
+#include "../ManeuverEvaluation.hpp"
+#include "../WorkspaceGraph.hpp"
 
 #pragma region ObstacleIntersection
 
@@ -43,4 +45,336 @@ TEST(ObstacleIntersection, Bug_001_Reverse)
             unsafe = true;
 
     ASSERT_TRUE(unsafe);
-}
\ No newline at end of file
+}
+
+TEST(ObstacleIntersection, DirectPath_ObstacleBetweenSamples)
+{
+    WorkspaceGraph workGraph;
+    workGraph.defineFreespace(Rectangle(-10, -10, -10, 110, 10, 10));
+    workGraph.addObstacle(50.5, 0, 0, 0.1);
+
+    GraphNode start(0, 0, 0, 0, 0, 1, 0), final(100, 0, 0, 0, 0, 2, 1);
+    ManeuverEngine::maneuverType = DirectPath;
+    ManeuverEngine::setMaxSampleStep(0);
+
+    // every sample lands on a whole number, so the sampled check misses the obstacle
+    ASSERT_TRUE(workGraph.pathIsSafe(ManeuverEngine::generatePath(start, final)));
+    ASSERT_FALSE(workGraph.segmentIsSafe(start, final));
+    ASSERT_FALSE(workGraph.pathIsSafe(start, final));
+    ASSERT_FALSE(ManeuverEvaluation(start, final).isSafe(workGraph));
+}
+
+TEST(ObstacleIntersection, DirectPath_SegmentLeavesFreespace)
+{
+    WorkspaceGraph workGraph;
+    workGraph.defineFreespace(Rectangle(0, 0, 0, 10, 10, 10));
+
+    ASSERT_TRUE(workGraph.segmentIsSafe(Point(1, 1, 1), Point(9, 9, 9)));
+    ASSERT_FALSE(workGraph.segmentIsSafe(Point(1, 1, 1), Point(11, 9, 9)));
+}
+
+// a level maneuver along its own heading is a straight line, so its samples are known exactly
+bool straightManeuverIsSafe(WorkspaceGraph& workGraph)
+{
+    GraphNode start(0, 0, 50, 0, 0, 1, 0), final(100, 0, 50, 0, 0, 2, 1);
+    ManeuverEngine::maneuverType = Dubins3d;
+    ManeuverEngine::setMaxSampleStep(1.0);
+    workGraph.defineFreespace(Rectangle(-10, -10, 0, 110, 10, 100));
+    workGraph.resetSampleStats();
+
+    bool isSafe = workGraph.pathIsSafe(start, final);
+    ManeuverEngine::setMaxSampleStep(0);
+    return isSafe;
+}
+
+TEST(ObstacleIntersection, Dubins3d_ClearBoundsSkipFineSampling)
+{
+    WorkspaceGraph workGraph;
+    workGraph.addObstacle(50, 0.5, 50, 0.3);
+
+    ASSERT_TRUE(straightManeuverIsSafe(workGraph));
+    GTEST_ASSERT_EQ(workGraph.samplesChecked(), 14);
+    GTEST_ASSERT_EQ(workGraph.boundsChecked(), 13);
+}
+
+TEST(ObstacleIntersection, Dubins3d_InconclusiveBoundRefined)
+{
+    // sits between the coarse samples at 0 and 7.7 but on the fine sample at 2.9
+    WorkspaceGraph workGraph;
+    workGraph.addObstacle(3.0, 0, 50, 0.3);
+
+    ASSERT_FALSE(straightManeuverIsSafe(workGraph));
+    GTEST_ASSERT_GT(workGraph.samplesChecked(), 14);
+}
+
+#pragma endregion //ObstacleIntersection
+
+#pragma region SampleOrder
+
+TEST(SampleOrder, Bisection_FindsMidpointCollisionEarly)
+{
+    ManeuverEngine::maneuverType = DirectPath;
+    ManeuverEngine::setMaxSampleStep(0);
+    auto path = ManeuverEngine::generatePath(State(10, 50, 50, 0, 0), State(90, 50, 50, 0, 0));
+
+    unsigned long rejectionSamples[2];
+    for (auto order : { SequentialOrder, BisectionOrder })
+    {
+        WorkspaceGraph workGraph;
+        workGraph.defineFreespace(Rectangle(0, 0, 0, 100, 100, 100));
+        workGraph.addObstacle(50, 50, 50, 2);
+        workGraph.setSampleOrder(order);
+
+        ASSERT_FALSE(workGraph.pathIsSafe(path));
+        GTEST_ASSERT_EQ(workGraph.pathsRejected(), 1);
+        rejectionSamples[order] = workGraph.rejectionSamples();
+    }
+
+    // the sequential check walks up to the obstacle; the bisection check hits it on its 7th sample
+    GTEST_ASSERT_GT(rejectionSamples[SequentialOrder], 45);
+    GTEST_ASSERT_EQ(rejectionSamples[BisectionOrder], 7);
+}
+
+TEST(SampleOrder, AllOrders_SameResults)
+{
+    srand(19);
+    ManeuverEngine::maneuverType = DirectPath;
+    ManeuverEngine::setMaxSampleStep(0.5);
+
+    // few obstacles are checked in blocks by the store, many through the bvh, and with a
+    // distance field samples within the clearance of a checked one are skipped
+    for (int numObstacles : { 30, 300, -300 })
+    {
+        auto obstacles = buildRandomObstacles(abs(numObstacles));
+        WorkspaceGraph sequential, bisection;
+        for (auto workGraph : { &sequential, &bisection })
+        {
+            workGraph->defineFreespace(Rectangle(0, 0, 0, 100, 100, 100));
+            workGraph->addObstacles(obstacles);
+            if (numObstacles < 0)
+                workGraph->buildDistanceField(1.0);
+        }
+        sequential.setSampleOrder(SequentialOrder);
+
+        for (int i = 0; i < 500; ++i)
+        {
+            Point p1(rand() % 1000 / 10.0, rand() % 1000 / 10.0, rand() % 1000 / 10.0);
+            Point p2(p1.x() + rand() % 300 / 10.0 - 15, p1.y() + rand() % 300 / 10.0 - 15, p1.z() + rand() % 100 / 10.0 - 5);
+            auto path = ManeuverEngine::generatePath(State(p1, 0, 0), State(p2, 0, 0));
+            GTEST_ASSERT_EQ(bisection.pathIsSafe(path), sequential.pathIsSafe(path));
+        }
+
+        GTEST_ASSERT_EQ(bisection.pathsRejected(), sequential.pathsRejected());
+        GTEST_ASSERT_GT(bisection.pathsRejected(), 0);
+        GTEST_ASSERT_LT(bisection.rejectionSamples(), sequential.rejectionSamples());
+        for (auto o : obstacles)
+            delete o;
+    }
+    ManeuverEngine::setMaxSampleStep(0);
+}
+
+#pragma endregion //SampleOrder
+
+#pragma region PathLengthLowerBound
+
+TEST(PathLengthLowerBound, DirectPath_EqualsLength)
+{
+    State start(1, 2, 3, 0.5, 0.1);
+    State final(10, -4, 8, 2.5, -0.2);
+
+    ManeuverEngine::maneuverType = DirectPath;
+    GTEST_ASSERT_EQ(ManeuverEngine::getPathLengthLowerBound(start, final), ManeuverEngine::getPathLength(start, final));
+}
+
+TEST(PathLengthLowerBound, Dubins3d_NeverExceedsLength)
+{
+    srand(17);
+    ManeuverEngine::maneuverType = Dubins3d;
+    for (int i = 0; i < 200; ++i)
+    {
+        State start(rand() % 100, rand() % 100, rand() % 40, rand() % 628 / 100.0, (rand() % 100 - 50) / 100.0);
+        State final(rand() % 100, rand() % 100, rand() % 40, rand() % 628 / 100.0, (rand() % 100 - 50) / 100.0);
+
+        double length = ManeuverEngine::getPathLength(start, final);
+        if (length > 0)
+            EXPECT_LE(ManeuverEngine::getPathLengthLowerBound(start, final), length + 1e-9);
+    }
+}
+
+TEST(PathLengthLowerBound, Dubins3d_ReversedHeading_AtLeastHalfTurn)
+{
+    State start(0, 0, 0, 0, 0);
+    State final(1, 0, 0, M_PI, 0);
+
+    ManeuverEngine::maneuverType = Dubins3d;
+    EXPECT_GE(ManeuverEngine::getPathLengthLowerBound(start, final), RHO_MIN * M_PI - 1e-9);
+}
+
+TEST(PathLengthLowerBound, Dubins3d_SteepClimb_LimitedByPitch)
+{
+    State start(0, 0, 0, 0, 0);
+    State final(1, 0, 10, 0, 0);
+
+    ManeuverEngine::maneuverType = Dubins3d;
+    EXPECT_GE(ManeuverEngine::getPathLengthLowerBound(start, final), 10 / sin(PITCH_MAX_DEG) - 1e-9);
+}
+
+
+#pragma endregion //PathLengthLowerBound
+
+#pragma region PathLength
+
+TEST(PathLength, Dubins3d_LengthOnlyMatchesSampledManeuver)
+{
+    srand(19);
+    ManeuverEngine::maneuverType = Dubins3d;
+    auto& cache = ManeuverEngine::maneuverCache();
+    unsigned long defaultCapacity = cache.capacity();
+
+    for (int i = 0; i < 50; ++i)
+    {
+        State start(rand() % 100, rand() % 100, rand() % 40, rand() % 628 / 100.0, 0);
+        State final(rand() % 100, rand() % 100, rand() % 40, rand() % 628 / 100.0, 0);
+        State3d qi { start.x(), start.y(), start.z(), start.theta(), start.rho() };
+        State3d qf { final.x(), final.y(), final.z(), final.theta(), final.rho() };
+        double expected = DubinsManeuver3d(qi, qf, RHO_MIN, { PITCH_MIN_DEG, PITCH_MAX_DEG }).length();
+
+        cache.setCapacity(0);
+        GTEST_ASSERT_EQ(ManeuverEngine::getPathLength(start, final), expected);
+        cache.setCapacity(defaultCapacity);
+        GTEST_ASSERT_EQ(ManeuverEngine::getPathLength(start, final), expected);
+        GTEST_ASSERT_EQ(ManeuverEngine::getPathLength(start, final), expected);
+    }
+}
+
+#pragma endregion //PathLength
+
+#pragma region SampleSpacing
+
+TEST(SampleSpacing, NoMaxStep_UsesFixedCount)
+{
+    ManeuverEngine::maneuverType = DirectPath;
+    ManeuverEngine::setMaxSampleStep(0);
+
+    GTEST_ASSERT_EQ(ManeuverEngine::sampleCount(0.5), NUM_SAMPLES);
+    GTEST_ASSERT_EQ(ManeuverEngine::generatePath(State(0, 0, 0, 0, 0), State(50, 0, 0, 0, 0)).size(), NUM_SAMPLES);
+}
+
+TEST(SampleSpacing, DirectPath_SamplesNoFurtherApartThanMaxStep)
+{
+    ManeuverEngine::maneuverType = DirectPath;
+    ManeuverEngine::setMaxSampleStep(2.0);
+
+    auto shortPath = ManeuverEngine::generatePath(State(0, 0, 0, 0, 0), State(0.5, 0, 0, 0, 0));
+    auto longPath = ManeuverEngine::generatePath(State(0, 0, 0, 0, 0), State(30, 40, 0, 0, 0));
+    ManeuverEngine::setMaxSampleStep(0);
+
+    GTEST_ASSERT_EQ(shortPath.size(), MIN_SAMPLES);
+    GTEST_ASSERT_EQ(longPath.size(), 25);
+    for (int i = 1; i < longPath.size(); ++i)
+        GTEST_ASSERT_LE(longPath[i].distanceTo(longPath[i - 1]), 2.0 + 1e-9);
+    GTEST_ASSERT_LE(longPath.back().distanceTo(State(30, 40, 0, 0, 0)), 2.0 + 1e-9);
+}
+
+TEST(SampleSpacing, Dubins3d_SamplesNoFurtherApartThanMaxStep)
+{
+    // Dubins paths include both end states, so the gaps are length / (count - 1); a straight
+    // maneuver keeps the gaps between samples equal to the arc length between them
+    ManeuverEngine::maneuverType = Dubins3d;
+    ManeuverEngine::setMaxSampleStep(2.0);
+
+    State start(0, 0, 0, 0, 0);
+    State final(21, 0, 0, 0, 0);
+    auto path = ManeuverEngine::generatePath(start, final);
+    ManeuverEngine::setMaxSampleStep(0);
+
+    ASSERT_GE(path.size(), MIN_SAMPLES);
+    EXPECT_NEAR(path.front().distanceTo(start), 0, 1e-6);
+    EXPECT_NEAR(path.back().distanceTo(final), 0, 1e-6);
+    for (int i = 1; i < path.size(); ++i)
+        GTEST_ASSERT_LE(path[i].distanceTo(path[i - 1]), 2.0 + 1e-9);
+}
+
+TEST(SampleSpacing, SampleCount_Clamped)
+{
+    ManeuverEngine::setMaxSampleStep(1e-6);
+    int longCount = ManeuverEngine::sampleCount(100);
+    ManeuverEngine::setMaxSampleStep(0);
+
+    GTEST_ASSERT_EQ(longCount, MAX_SAMPLES);
+}
+
+#pragma endregion //SampleSpacing
+
+#pragma region ManeuverEvaluation
+
+TEST(ManeuverEvaluation, MatchesManeuverEngine)
+{
+    State start(1, 2, 3, 0.5, 0.1);
+    State final(40, -14, 8, 2.5, -0.2);
+
+    for (auto maneuverType : { DirectPath, Dubins3d })
+    {
+        ManeuverEngine::maneuverType = maneuverType;
+        ManeuverEvaluation evaluation(start, final);
+        GTEST_ASSERT_EQ(evaluation.length(), ManeuverEngine::getPathLength(start, final));
+
+        auto expected = ManeuverEngine::generatePath(start, final);
+        auto& actual = evaluation.path();
+        GTEST_ASSERT_EQ(actual.size(), expected.size());
+        for (int i = 0; i < actual.size(); ++i)
+            GTEST_ASSERT_EQ(actual[i].distanceTo(expected[i]), 0);
+    }
+}
+
+TEST(ManeuverEvaluation, ConstructsManeuverOnce)
+{
+    WorkspaceGraph workGraph;
+    workGraph.defineFreespace(Rectangle(-100, -100, -100, 100, 100, 100));
+    ManeuverEngine::maneuverType = Dubins3d;
+    ManeuverEngine::maneuverCache().clear();
+    ManeuverEvaluation::resetStats();
+
+    ManeuverEvaluationCache evaluations;
+    State start(1, 2, 3, 0.5, 0.1);
+    State final(40, -14, 8, 2.5, -0.2);
+    evaluations.evaluate(start, final).length();
+    evaluations.evaluate(start, final).path();
+    evaluations.evaluate(start, final).isSafe(workGraph);
+    evaluations.evaluate(start, final).isSafe(workGraph);
+
+    GTEST_ASSERT_EQ(evaluations.size(), 1);
+    GTEST_ASSERT_EQ(ManeuverEvaluation::stats().requests, 4);
+    GTEST_ASSERT_EQ(ManeuverEvaluation::stats().constructions, 1);
+
+    evaluations.evaluate(final, start).length();
+    GTEST_ASSERT_EQ(evaluations.size(), 2);
+    GTEST_ASSERT_EQ(ManeuverEvaluation::stats().constructions, 2);
+
+    // a new iteration's cost is answered by the maneuver cache without constructing again
+    evaluations.clear();
+    GTEST_ASSERT_EQ(evaluations.size(), 0);
+    evaluations.evaluate(start, final).length();
+    GTEST_ASSERT_EQ(ManeuverEvaluation::stats().constructions, 2);
+}
+
+TEST(ManeuverEvaluation, DirectPathIsNotCounted)
+{
+    WorkspaceGraph workGraph;
+    workGraph.defineFreespace(Rectangle(-100, -100, -100, 100, 100, 100));
+    ManeuverEngine::maneuverType = DirectPath;
+    ManeuverEvaluation::resetStats();
+
+    ManeuverEvaluationCache evaluations;
+    State start(1, 2, 3, 0.5, 0.1);
+    State final(40, -14, 8, 2.5, -0.2);
+    EXPECT_NEAR(evaluations.evaluate(start, final).length(), start.distanceTo(final), 1e-9);
+    evaluations.evaluate(start, final).path();
+    EXPECT_TRUE(evaluations.evaluate(start, final).isSafe(workGraph));
+
+    // requests and constructions are both Dubins3d only, so the two can be compared
+    GTEST_ASSERT_EQ(ManeuverEvaluation::stats().requests, 0);
+    GTEST_ASSERT_EQ(ManeuverEvaluation::stats().constructions, 0);
+}
+
+#pragma endregion //ManeuverEvaluation
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "../NodeArena.hpp"
+
+#pragma region NodeArena
+
+TEST(NodeArena, Empty_CheckVals)
+{
+    NodeArena arena;
+    GTEST_ASSERT_EQ(arena.size(), 0);
+    EXPECT_TRUE(arena.empty());
+    EXPECT_FALSE(arena.contains(0));
+    EXPECT_TRUE(arena.begin() == arena.end());
+    GTEST_ASSERT_EQ(arena[0].id(), 0);
+    EXPECT_ANY_THROW(arena.at(1));
+}
+
+TEST(NodeArena, Insert_IdIsSlot)
+{
+    NodeArena arena;
+    arena.insert(ConfigspaceNode(1, 2, 3, 0, 0, 1, 0, 0));
+    arena.insert(ConfigspaceNode(4, 5, 6, 0, 0, 2, 1, 7.5));
+
+    GTEST_ASSERT_EQ(arena.size(), 2);
+    GTEST_ASSERT_EQ(arena[2].x(), 4);
+    GTEST_ASSERT_EQ(arena.at(2).parentId(), 1);
+    GTEST_ASSERT_EQ(arena.at(2).cost(), 7.5);
+
+    arena.insert(ConfigspaceNode(9, 9, 9, 0, 0, 2, 1, 1));
+    GTEST_ASSERT_EQ(arena.size(), 2);
+    GTEST_ASSERT_EQ(arena[2].x(), 9);
+}
+
+TEST(NodeArena, Grow_KeepsReferencesStable)
+{
+    NodeArena arena;
+    ConfigspaceNode& first = arena.insert(ConfigspaceNode(1, 1, 1, 0, 0, 1, 0, 0));
+    for (unsigned long id = 2; id < 5 * NODE_ARENA_CHUNK_SIZE; ++id)
+        arena.insert(ConfigspaceNode(id, 0, 0, 0, 0, id, id - 1, 0));
+
+    GTEST_ASSERT_EQ(&first, &arena[1]);
+    GTEST_ASSERT_EQ(first.x(), 1);
+    GTEST_ASSERT_EQ(arena.size(), 5 * NODE_ARENA_CHUNK_SIZE - 1);
+}
+
+TEST(NodeArena, Erase_SkippedByIteration)
+{
+    NodeArena arena;
+    for (unsigned long id = 1; id <= 5; ++id)
+        arena.insert(ConfigspaceNode(id, 0, 0, 0, 0, id, 0, 0));
+    arena.erase(3);
+    arena.erase(3);
+
+    GTEST_ASSERT_EQ(arena.size(), 4);
+    EXPECT_FALSE(arena.contains(3));
+
+    vector<unsigned long> ids;
+    for (auto& node : arena)
+        ids.push_back(node.id());
+    EXPECT_EQ(ids, vector<unsigned long>({ 1, 2, 4, 5 }));
+}
+
+TEST(NodeArena, Copy_IsDeep)
+{
+    NodeArena arena;
+    arena.insert(ConfigspaceNode(1, 0, 0, 0, 0, 1, 0, 0));
+    NodeArena copy = arena;
+    copy[1].setCost(10);
+    copy.insert(ConfigspaceNode(2, 0, 0, 0, 0, 2, 1, 0));
+
+    GTEST_ASSERT_EQ(arena[1].cost(), 0);
+    GTEST_ASSERT_EQ(arena.size(), 1);
+    GTEST_ASSERT_EQ(copy.size(), 2);
+}
+
+#pragma endregion //NodeArena
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "../DistanceKernels.hpp"
+#include "../KdTree.hpp"
+#include "../NodePositionStore.hpp"
+
+#pragma region DistanceKernels
+
+TEST(DistanceKernels, AllSupportedKernels_MatchScalar)
+{
+    srand(9);
+    int n = 1003;
+    vector<double> xs(n), ys(n), zs(n), expected(n), actual(n);
+    for (int i = 0; i < n; ++i)
+    {
+        xs[i] = rand() / (double)RAND_MAX * 100;
+        ys[i] = rand() / (double)RAND_MAX * 100;
+        zs[i] = rand() / (double)RAND_MAX * 100;
+    }
+    double point[3] = { 41.3, 7.9, 66.1 };
+
+    auto defaultType = DistanceKernels::kernelType();
+    DistanceKernels::setKernelType(ScalarKernel);
+    double expectedBest;
+    auto expectedIndex = DistanceKernels::nearestIndex(xs.data(), ys.data(), zs.data(), n, point, expectedBest);
+    DistanceKernels::squaredDistances(xs.data(), ys.data(), zs.data(), n, point, expected.data());
+
+    for (auto type : { Avx2Kernel, Avx512Kernel })
+    {
+        if (!DistanceKernels::isSupported(type))
+            continue;
+
+        DistanceKernels::setKernelType(type);
+        GTEST_ASSERT_EQ(DistanceKernels::kernelType(), type);
+
+        double actualBest;
+        GTEST_ASSERT_EQ(DistanceKernels::nearestIndex(xs.data(), ys.data(), zs.data(), n, point, actualBest), expectedIndex);
+        GTEST_ASSERT_EQ(actualBest, expectedBest);
+
+        DistanceKernels::squaredDistances(xs.data(), ys.data(), zs.data(), n, point, actual.data());
+        for (int i = 0; i < n; ++i)
+            GTEST_ASSERT_EQ(actual[i], expected[i]);
+    }
+    DistanceKernels::setKernelType(defaultType);
+}
+
+TEST(DistanceKernels, NearestIndex_TiesReturnLowestIndex)
+{
+    vector<double> xs(20, 5.0), ys(20, 0.0), zs(20, 0.0);
+    xs[6] = 1;
+    xs[13] = 1;
+    double point[3] = { 0, 0, 0 }, best;
+    GTEST_ASSERT_EQ(DistanceKernels::nearestIndex(xs.data(), ys.data(), zs.data(), 20, point, best), 6);
+    GTEST_ASSERT_EQ(best, 1);
+}
+
+TEST(DistanceKernels, NearestIndex_Empty)
+{
+    double point[3] = { 0, 0, 0 }, best;
+    GTEST_ASSERT_EQ(DistanceKernels::nearestIndex(nullptr, nullptr, nullptr, 0, point, best), 0);
+    EXPECT_TRUE(isinf(best));
+}
+
+#pragma endregion //DistanceKernels
+
+#pragma region NodePositionStore
+
+TEST(NodePositionStore, FindNearest_MatchesKdTree)
+{
+    srand(13);
+    NodePositionStore store;
+    KdTree tree;
+    auto points = generateRandomPoints(1500);
+    for (int i = 0; i < points.size(); ++i)
+    {
+        store.insert(i + 1, points[i]);
+        tree.insert(i + 1, points[i]);
+    }
+
+    for (auto& q : generateRandomPoints(100))
+    {
+        EXPECT_DOUBLE_EQ(points[store.findNearest(q) - 1].distanceTo(q), points[tree.findNearest(q) - 1].distanceTo(q));
+
+        auto storeIds = store.findNearest(q, 10, 15);
+        auto treeIds = tree.findNearest(q, 10, 15);
+        GTEST_ASSERT_EQ(storeIds.size(), treeIds.size());
+        for (int i = 0; i < storeIds.size(); ++i)
+            EXPECT_DOUBLE_EQ(points[storeIds[i] - 1].distanceTo(q), points[treeIds[i] - 1].distanceTo(q));
+    }
+}
+
+TEST(NodePositionStore, Remove_KeepsRemainingIds)
+{
+    NodePositionStore store;
+    store.insert(1, Point(0, 0, 0));
+    store.insert(2, Point(5, 0, 0));
+    store.insert(3, Point(10, 0, 0));
+    store.remove(1);
+
+    GTEST_ASSERT_EQ(store.size(), 2);
+    EXPECT_FALSE(store.contains(1));
+    GTEST_ASSERT_EQ(store.findNearest(Point(0, 0, 0)), 2);
+    GTEST_ASSERT_EQ(store.findNearest(Point(11, 0, 0)), 3);
+}
+
+TEST(NodePositionStore, Update_MovesNode)
+{
+    NodePositionStore store;
+    store.insert(1, Point(0, 0, 0));
+    store.insert(2, Point(5, 0, 0));
+    store.update(1, Point(20, 0, 0));
+
+    GTEST_ASSERT_EQ(store.findNearest(Point(19, 0, 0)), 1);
+    GTEST_ASSERT_EQ(store.findNearest(Point(0, 0, 0)), 2);
+}
+
+TEST(NodePositionStore, FindAllNearest_MatchesSingleQueries)
+{
+    srand(17);
+    NodePositionStore store;
+    auto points = generateRandomPoints(5000);
+    for (int i = 0; i < points.size(); ++i)
+        store.insert(i + 1, points[i]);
+
+    auto queries = generateRandomPoints(300);
+    auto ids = store.findAllNearest(queries);
+    GTEST_ASSERT_EQ(ids.size(), queries.size());
+    for (int i = 0; i < queries.size(); ++i)
+        GTEST_ASSERT_EQ(ids[i], store.findNearest(queries[i]));
+
+    GTEST_ASSERT_EQ(NodePositionStore().findAllNearest(queries)[0], 0);
+}
+
+#pragma endregion //NodePositionStore
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "../Geometry3D.hpp"
+#include "../ObstacleBvh.hpp"
+
+#pragma region ObstacleBvh
+
+// spheres and rectangles of mixed sizes scattered over a 100 x 100 x 100 box
+vector<Shape3d*> buildRandomObstacles(int numObstacles)
+{
+    vector<Shape3d*> obstacles;
+    for (int i = 0; i < numObstacles; ++i)
+    {
+        double x = rand() % 1000 / 10.0, y = rand() % 1000 / 10.0, z = rand() % 1000 / 10.0;
+        double size = 0.5 + rand() % 40 / 10.0;
+        if (i % 2)
+            obstacles.push_back(new Sphere(x, y, z, size));
+        else
+            obstacles.push_back(new Rectangle(x, y, z, x + size, y + 2 * size, z + size / 2));
+    }
+    return obstacles;
+}
+
+TEST(ObstacleBvh, Empty_NoIntersections)
+{
+    ObstacleBvh bvh;
+    GTEST_ASSERT_EQ(bvh.size(), 0);
+    EXPECT_FALSE(bvh.intersects(Point(1, 2, 3)));
+    EXPECT_FALSE(bvh.intersectsCapsule(Line(Point(0, 0, 0), Point(10, 10, 10)), 5));
+}
+
+TEST(ObstacleBvh, RandomQueries_MatchLinearScan)
+{
+    srand(16);
+    auto obstacles = buildRandomObstacles(500);
+    ObstacleBvh bvh(obstacles);
+    GTEST_ASSERT_EQ(bvh.size(), 500);
+    GTEST_ASSERT_LE(bvh.depth(), 10);
+
+    for (int i = 0; i < 500; ++i)
+    {
+        Point p1(rand() % 1000 / 10.0, rand() % 1000 / 10.0, rand() % 1000 / 10.0);
+        Point p2(p1.x() + rand() % 200 / 10.0 - 10, p1.y() + rand() % 200 / 10.0 - 10, p1.z());
+        Line segment(p1, p2);
+        double radius = rand() % 30 / 10.0;
+
+        bool pointHit = false, segmentHit = false, capsuleHit = false;
+        for (auto o : obstacles)
+        {
+            pointHit |= o->intersects(p1);
+            segmentHit |= o->intersects(segment);
+            capsuleHit |= o->intersectsCapsule(segment, radius);
+        }
+
+        GTEST_ASSERT_EQ(bvh.intersects(p1), pointHit);
+        GTEST_ASSERT_EQ(bvh.intersects(segment), segmentHit);
+        GTEST_ASSERT_EQ(bvh.intersectsCapsule(segment, radius), capsuleHit);
+    }
+
+    for (auto o : obstacles)
+        delete o;
+}
+
+TEST(ObstacleBvh, UnboundedShape_AlwaysTested)
+{
+    Shape3d unbounded;
+    vector<Shape3d*> obstacles = { new Sphere(0, 0, 0, 1), &unbounded };
+    ObstacleBvh bvh(obstacles);
+
+    // the base shape reports an intersection everywhere
+    EXPECT_TRUE(bvh.intersects(Point(500, 500, 500)));
+    delete obstacles[0];
+}
+
+#pragma endregion //ObstacleBvh
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <math.h>
+#include "../DistanceKernels.hpp"
+#include "../Geometry3D.hpp"
+#include "../ObstacleStore.hpp"
+
+#pragma region ObstacleStore
+
+// points on the surface of every obstacle and one ulp to either side of it, where a kernel
+// that rounds differently from Shape3d would give a different answer
+vector<Point> buildBoundaryPoints(const vector<Shape3d*>& obstacles)
+{
+    vector<Point> points;
+    for (auto o : obstacles)
+    {
+        vector<Point> surface;
+        if (auto sphere = dynamic_cast<const Sphere*>(o))
+        {
+            double r = sphere->radius(), d = r / sqrt(3.0);
+            surface = { Point(sphere->x() + r, sphere->y(), sphere->z()), Point(sphere->x(), sphere->y() - r, sphere->z()),
+                Point(sphere->x() + d, sphere->y() + d, sphere->z() - d) };
+        }
+        else if (auto rect = dynamic_cast<const Rectangle*>(o))
+            surface = { rect->minPoint(), rect->maxPoint(), Point(rect->maxX(), rect->minY(), (rect->minZ() + rect->maxZ()) / 2) };
+
+        for (auto& p : surface)
+        {
+            points.push_back(p);
+            points.push_back(Point(nextafter(p.x(), -INFINITY), nextafter(p.y(), INFINITY), p.z()));
+            points.push_back(Point(nextafter(p.x(), INFINITY), p.y(), nextafter(p.z(), -INFINITY)));
+        }
+    }
+    return points;
+}
+
+bool linearScanIntersects(const vector<Shape3d*>& obstacles, const Point& p)
+{
+    for (auto o : obstacles)
+        if (o->intersects(p))
+            return true;
+    return false;
+}
+
+TEST(ObstacleStore, Empty_NoIntersections)
+{
+    ObstacleStore store;
+    double xs[] = { 1 }, ys[] = { 2 }, zs[] = { 3 };
+    GTEST_ASSERT_EQ(store.size(), 0);
+    EXPECT_FALSE(store.intersects(Point(1, 2, 3)));
+    GTEST_ASSERT_EQ(store.firstIntersecting(xs, ys, zs, 1), 1);
+}
+
+TEST(ObstacleStore, AllSupportedKernels_MatchShape3d)
+{
+    srand(18);
+    auto obstacles = buildRandomObstacles(301);
+    ObstacleStore store(obstacles);
+    GTEST_ASSERT_EQ(store.numSpheres(), 150);
+    GTEST_ASSERT_EQ(store.numBoxes(), 151);
+
+    auto points = buildBoundaryPoints(obstacles);
+    for (int i = 0; i < 500; ++i)
+        points.push_back(Point(rand() % 1000 / 10.0, rand() % 1000 / 10.0, rand() % 1000 / 10.0));
+
+    vector<char> expected(points.size());
+    for (int i = 0; i < points.size(); ++i)
+        expected[i] = linearScanIntersects(obstacles, points[i]);
+
+    auto defaultType = DistanceKernels::kernelType();
+    for (auto type : { ScalarKernel, Avx2Kernel, Avx512Kernel })
+    {
+        if (!DistanceKernels::isSupported(type))
+            continue;
+        DistanceKernels::setKernelType(type);
+
+        for (int i = 0; i < points.size(); ++i)
+            GTEST_ASSERT_EQ(store.intersects(points[i]), (bool)expected[i]);
+    }
+    DistanceKernels::setKernelType(defaultType);
+
+    for (auto o : obstacles)
+        delete o;
+}
+
+TEST(ObstacleStore, FirstIntersecting_MatchesPointByPoint)
+{
+    srand(19);
+    auto obstacles = buildRandomObstacles(40);
+    ObstacleStore store(obstacles);
+
+    // blocks of every length up to a few vectors, so the vector tails are covered as well
+    auto points = buildBoundaryPoints(obstacles);
+    vector<double> xs, ys, zs;
+    for (auto& p : points)
+    {
+        xs.push_back(p.x());
+        ys.push_back(p.y());
+        zs.push_back(p.z());
+    }
+
+    auto defaultType = DistanceKernels::kernelType();
+    for (auto type : { ScalarKernel, Avx2Kernel, Avx512Kernel })
+    {
+        if (!DistanceKernels::isSupported(type))
+            continue;
+        DistanceKernels::setKernelType(type);
+
+        for (unsigned long begin = 0; begin + 20 <= points.size(); begin += 7)
+        {
+            for (unsigned long n = 0; n <= 20; ++n)
+            {
+                // the first point that any obstacle intersects, or n if none does
+                unsigned long expected = n;
+                for (unsigned long i = 0; i < n && expected == n; ++i)
+                    if (linearScanIntersects(obstacles, points[begin + i]))
+                        expected = i;
+                GTEST_ASSERT_EQ(store.firstIntersecting(&xs[begin], &ys[begin], &zs[begin], n), expected);
+            }
+        }
+    }
+    DistanceKernels::setKernelType(defaultType);
+
+    for (auto o : obstacles)
+        delete o;
+}
+
+TEST(ObstacleStore, OtherShape_TestedThroughShape3d)
+{
+    Shape3d unbounded;
+    vector<Shape3d*> obstacles = { new Sphere(0, 0, 0, 1), &unbounded };
+    ObstacleStore store(obstacles);
+    GTEST_ASSERT_EQ(store.numOtherShapes(), 1);
+
+    // the base shape reports an intersection everywhere
+    double xs[] = { 0.5, 500 }, ys[] = { 0, 500 }, zs[] = { 0, 500 };
+    EXPECT_TRUE(store.intersects(Point(500, 500, 500)));
+    GTEST_ASSERT_EQ(store.firstIntersecting(xs + 1, ys + 1, zs + 1, 1), 0);
+    GTEST_ASSERT_EQ(store.firstIntersecting(xs, ys, zs, 2), 0);
+    delete obstacles[0];
+}
+
+#pragma endregion //ObstacleStore
\ No newline at end of file
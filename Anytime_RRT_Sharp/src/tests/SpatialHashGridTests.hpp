@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "../KdTree.hpp"
+#include "../SpatialHashGrid.hpp"
+
+#pragma region SpatialHashGrid
+
+TEST(SpatialHashGrid, Empty_FindNearest_ReturnsZero)
+{
+    SpatialHashGrid grid(5);
+    GTEST_ASSERT_EQ(grid.size(), 0);
+    GTEST_ASSERT_EQ(grid.findNearest(Point(1, 2, 3)), 0);
+    GTEST_ASSERT_EQ(grid.findNearest(Point(1, 2, 3), 5, 10).size(), 0);
+}
+
+TEST(SpatialHashGrid, FindNearest_FarFromAllCells)
+{
+    SpatialHashGrid grid(1);
+    grid.insert(1, Point(0, 0, 0));
+    grid.insert(2, Point(-40, 3, 2));
+    GTEST_ASSERT_EQ(grid.findNearest(Point(-100, 0, 0)), 2);
+    GTEST_ASSERT_EQ(grid.findNearest(Point(100, 100, 100)), 1);
+}
+
+TEST(SpatialHashGrid, FindNearest_MatchesKdTree)
+{
+    srand(3);
+    SpatialHashGrid grid(4);
+    KdTree tree;
+    auto points = generateRandomPoints(2000);
+    for (int i = 0; i < points.size(); ++i)
+    {
+        grid.insert(i + 1, points[i]);
+        tree.insert(i + 1, points[i]);
+    }
+
+    for (auto& q : generateRandomPoints(200))
+        EXPECT_DOUBLE_EQ(points[grid.findNearest(q) - 1].distanceTo(q), points[tree.findNearest(q) - 1].distanceTo(q));
+}
+
+TEST(SpatialHashGrid, FindKNearest_MatchesKdTree)
+{
+    srand(5);
+    SpatialHashGrid grid;
+    KdTree tree;
+    auto points = generateRandomPoints(2000);
+    for (int i = 0; i < points.size(); ++i)
+    {
+        grid.insert(i + 1, points[i]);
+        tree.insert(i + 1, points[i]);
+    }
+    grid.setQueryRadius(8);
+
+    for (auto& q : generateRandomPoints(50))
+    {
+        auto gridIds = grid.findNearest(q, 10, 8);
+        auto treeIds = tree.findNearest(q, 10, 8);
+        GTEST_ASSERT_EQ(gridIds.size(), treeIds.size());
+        for (int i = 0; i < gridIds.size(); ++i)
+            EXPECT_DOUBLE_EQ(points[gridIds[i] - 1].distanceTo(q), points[treeIds[i] - 1].distanceTo(q));
+    }
+}
+
+TEST(SpatialHashGrid, SetQueryRadius_Rebuckets)
+{
+    SpatialHashGrid grid(10);
+    grid.insert(1, Point(0, 0, 0));
+    grid.insert(2, Point(3, 0, 0));
+
+    grid.setQueryRadius(7);
+    GTEST_ASSERT_EQ(grid.cellSize(), 10);
+
+    grid.setQueryRadius(2);
+    GTEST_ASSERT_EQ(grid.cellSize(), 2);
+    GTEST_ASSERT_EQ(grid.findNearest(Point(2.9, 0, 0), 5, 2).size(), 1);
+
+    grid.setQueryRadius(20);
+    GTEST_ASSERT_EQ(grid.cellSize(), 20);
+    GTEST_ASSERT_EQ(grid.findNearest(Point(2.9, 0, 0), 5, 20).size(), 2);
+}
+
+TEST(SpatialHashGrid, RemoveAndUpdate)
+{
+    SpatialHashGrid grid(2);
+    grid.insert(1, Point(0, 0, 0));
+    grid.insert(2, Point(10, 10, 10));
+    grid.remove(1);
+
+    EXPECT_FALSE(grid.contains(1));
+    GTEST_ASSERT_EQ(grid.findNearest(Point(0, 0, 0)), 2);
+
+    grid.insert(1, Point(0, 0, 0));
+    grid.update(2, Point(-1, 0, 0));
+    GTEST_ASSERT_EQ(grid.size(), 2);
+    GTEST_ASSERT_EQ(grid.findNearest(Point(-2, 0, 0)), 2);
+}
+
+#pragma endregion //SpatialHashGrid
\ No newline at end of file
@@ -1,7 +1,19 @@
 #include <gtest/gtest.h>
+#include "ArrtsEngineTests.hpp"
 #include "ArrtsParamsTests.hpp"
+#include "ConfigspaceGraphTests.hpp"
 #include "Geometry2DTests.hpp"
 #include "Geometry3DTests.hpp"
+#include "GoalNodeSetTests.hpp"
+#include "KdTreeTests.hpp"
+#include "LookaheadQueueTests.hpp"
+#include "NodeArenaTests.hpp"
+#include "NodePositionStoreTests.hpp"
+#include "ObstacleBvhTests.hpp"
+#include "ObstacleStoreTests.hpp"
+#include "DistanceFieldTests.hpp"
+#include "SpatialHashGridTests.hpp"
+#include "ManeuverCacheTests.hpp"
 #include "ManeuverEngineTests.hpp"
 #include "VehicleTests.hpp"
 